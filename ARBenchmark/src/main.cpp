@@ -0,0 +1,292 @@
+#include <pch/arpch.h>
+#include <Asciir/Rendering/TerminalRenderer.h>
+
+#include <random>
+
+#ifndef AR_HEADLESS
+#error ARBenchmark requires the headless renderer (ASCIIR_HEADLESS=ON)
+#endif
+
+/// @brief microbenchmarks for the frame diffing and ansi encoding of the TerminalRenderer.
+///
+/// each scene draws a synthetic frame into a headless TerminalRenderer, and measures the time spent in TerminalRendererInterface::draw().
+/// the time spent drawing the tiles into the renderer is not part of the measurement.
+/// AsciiAttr::ansiCode() is measured on its own, with random colour and attribute changes.
+///
+/// usage:
+/// > ARBenchmark [--size <width> <height>] [--frames <n>] [--threads <n>] [--out <file>]
+///
+/// the width, height and frame count must be greater than 0.
+/// the results are written as JSON to stdout, or the passed file.
+/// all times are in nanoseconds, and all per cell values are per cell of the terminal, not per changed cell.
+///
+
+using namespace Asciir;
+
+struct BenchmarkResult
+{
+	std::string name;
+	double ns_per_cell;
+	double bytes_per_cell;
+	double changed_per_frame;
+};
+
+struct Scene
+{
+	const char* name;
+	// draws frame n of the scene into the renderer
+	std::function<void(TerminalRenderer&, size_t, std::mt19937&)> draw;
+	// the scene scrolls, so it is run with scroll detection enabled
+	bool scrolls = false;
+};
+
+static Colour randomColour(std::mt19937& rng)
+{
+	return Colour((unsigned char)(rng() & 0xFF), (unsigned char)(rng() & 0xFF), (unsigned char)(rng() & 0xFF));
+}
+
+static char randomAscii(std::mt19937& rng)
+{
+	return (char)('!' + rng() % ('~' - '!'));
+}
+
+static std::vector<Scene> scenes()
+{
+	// multi byte glyphs, from the block, box drawing, geometric shape and CJK ranges
+	static const char* unicode_glyphs[] = { u8"█", u8"▓", u8"▒", u8"░", u8"╔", u8"═", u8"◆", u8"★", u8"漢", u8"字" };
+
+	return {
+		{ "full_random", [](TerminalRenderer& renderer, size_t, std::mt19937& rng)
+			{
+				for (TInt y = 0; y < (TInt)renderer.drawHeight(); y++)
+					for (TInt x = 0; x < (TInt)renderer.drawWidth(); x++)
+						renderer.drawTile(x, y, Tile(randomColour(rng), randomColour(rng), randomAscii(rng)));
+			}
+		},
+		{ "sparse_1pct", [](TerminalRenderer& renderer, size_t, std::mt19937& rng)
+			{
+				size_t changes = std::max(renderer.drawWidth() * renderer.drawHeight() / 100, (size_t)1);
+
+				for (size_t i = 0; i < changes; i++)
+					renderer.drawTile((TInt)(rng() % renderer.drawWidth()), (TInt)(rng() % renderer.drawHeight()), Tile(randomColour(rng), randomColour(rng), randomAscii(rng)));
+			}
+		},
+		{ "solid_fill", [](TerminalRenderer& renderer, size_t frame, std::mt19937&)
+			{
+				// alternate between two colours, so every tile changes every frame, but the colours are the same for the entire frame.
+				Tile tile = frame % 2 ? Tile(Colour(20, 40, 200), WHITE8, ' ') : Tile(Colour(200, 40, 20), WHITE8, ' ');
+
+				for (TInt y = 0; y < (TInt)renderer.drawHeight(); y++)
+					for (TInt x = 0; x < (TInt)renderer.drawWidth(); x++)
+						renderer.drawTile(x, y, tile);
+			}
+		},
+		{ "scrolling_gradient", [](TerminalRenderer& renderer, size_t frame, std::mt19937&)
+			{
+				// the gradient moves up one row each frame
+				for (TInt y = 0; y < (TInt)renderer.drawHeight(); y++)
+				{
+					size_t row = y + frame;
+
+					for (TInt x = 0; x < (TInt)renderer.drawWidth(); x++)
+						renderer.drawTile(x, y, Tile(Colour((unsigned char)(row * 4), (unsigned char)(x * 2), (unsigned char)(row * x)), WHITE8, (char)('a' + row % 26)));
+				}
+			}, true
+		},
+		{ "unicode_glyphs", [](TerminalRenderer& renderer, size_t, std::mt19937& rng)
+			{
+				constexpr size_t glyph_count = sizeof(unicode_glyphs) / sizeof(*unicode_glyphs);
+
+				for (TInt y = 0; y < (TInt)renderer.drawHeight(); y++)
+					for (TInt x = 0; x < (TInt)renderer.drawWidth(); x++)
+						renderer.drawTile(x, y, Tile(BLACK8, Colour(200, 200, (unsigned char)(rng() % 2 * 50)), unicode_glyphs[rng() % glyph_count]));
+			}
+		}
+	};
+}
+
+static BenchmarkResult runScene(const Scene& scene, TermVert size, size_t frames, uint32_t threads)
+{
+	constexpr size_t WARMUP_FRAMES = 8;
+
+	TerminalRenderer::TerminalProps props("ARBenchmark", size);
+	props.scroll_detection = scene.scrolls;
+
+	TerminalRenderer renderer(props);
+	renderer.setEncodeThreads(threads);
+	renderer.update();
+
+	std::mt19937 rng(1);
+
+	duration draw_time(0);
+	size_t bytes = 0;
+	size_t changed = 0;
+
+	for (size_t frame = 0; frame < WARMUP_FRAMES + frames; frame++)
+	{
+		scene.draw(renderer, frame, rng);
+		renderer.update();
+
+		// the previous frame is written before the measurement, so draw() never waits for the writer.
+		renderer.waitForWriter();
+
+		DeltaTime start = getTime();
+		renderer.draw();
+		DeltaTime end = getTime();
+
+		if (frame < WARMUP_FRAMES)
+			continue;
+
+		draw_time += (end - start).durr();
+		bytes += renderer.getFrameStats().bytes;
+		changed += renderer.getFrameStats().changed_tiles;
+	}
+
+	renderer.waitForWriter();
+
+	double cells = (double)size.x * size.y * frames;
+
+	return { scene.name, draw_time.count() / cells, bytes / cells, (double)changed / frames };
+}
+
+static BenchmarkResult runAnsiCode(size_t iterations)
+{
+	AsciiAttr attr;
+	std::mt19937 rng(1);
+
+	std::vector<char> buffer(256);
+
+	duration ansi_time(0);
+	size_t bytes = 0;
+
+	// the colours are generated up front, so only ansiCode() is measured.
+	constexpr size_t BATCH_SIZE = 4096;
+	std::vector<std::pair<Colour, Colour>> colours(BATCH_SIZE);
+
+	for (size_t done = 0; done < iterations; done += BATCH_SIZE)
+	{
+		for (std::pair<Colour, Colour>& colour : colours)
+			colour = { rng() % 4 ? randomColour(rng) : WHITE8, rng() % 4 ? randomColour(rng) : BLACK8 };
+
+		DeltaTime start = getTime();
+
+		for (const std::pair<Colour, Colour>& colour : colours)
+		{
+			attr.setColour(colour.first, colour.second);
+			bytes += attr.ansiCode(buffer.data()) - buffer.data();
+		}
+
+		ansi_time += (getTime() - start).durr();
+	}
+
+	size_t calls = (iterations + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE;
+
+	return { "ansi_code", ansi_time.count() / (double)calls, bytes / (double)calls, 0 };
+}
+
+static void writeJson(std::ostream& out, TermVert size, size_t frames, uint32_t threads, const std::vector<BenchmarkResult>& results)
+{
+	out << std::fixed << std::setprecision(3);
+
+	out << "{\n"
+		<< "\t\"width\": " << size.x << ",\n"
+		<< "\t\"height\": " << size.y << ",\n"
+		<< "\t\"frames\": " << frames << ",\n"
+		<< "\t\"threads\": " << threads << ",\n"
+		<< "\t\"benchmarks\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+
+		out << "\t\t{ \"name\": \"" << result.name << "\", \"ns_per_cell\": " << result.ns_per_cell
+			<< ", \"bytes_per_cell\": " << result.bytes_per_cell << ", \"changed_per_frame\": " << result.changed_per_frame
+			<< " }" << (i + 1 < results.size() ? "," : "") << '\n';
+	}
+
+	out << "\t]\n}\n";
+}
+
+static void printUsage()
+{
+	std::cerr << "usage: ARBenchmark [--size <width> <height>] [--frames <n>] [--threads <n>] [--out <file>]\n";
+}
+
+// parses the entire string as an integer in the range [min, max], throws on failure
+static long long parseInt(const std::string& str, long long min, long long max)
+{
+	size_t parsed = 0;
+	long long value = std::stoll(str, &parsed);
+
+	if (parsed != str.size() || value < min || value > max)
+		throw std::out_of_range("argument out of range: " + str);
+
+	return value;
+}
+
+int main(int argc, char** argv)
+{
+	TermVert size(200, 60);
+	size_t frames = 200;
+	uint32_t threads = 0;
+	std::filesystem::path out_path;
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
+
+			if (arg == "--size" && i + 2 < argc)
+			{
+				size.x = (TInt)parseInt(argv[++i], 1, std::numeric_limits<TInt>::max());
+				size.y = (TInt)parseInt(argv[++i], 1, std::numeric_limits<TInt>::max());
+			}
+			else if (arg == "--frames" && i + 1 < argc)
+				frames = (size_t)parseInt(argv[++i], 1, std::numeric_limits<long long>::max());
+			else if (arg == "--threads" && i + 1 < argc)
+				threads = (uint32_t)parseInt(argv[++i], 0, std::numeric_limits<uint32_t>::max());
+			else if (arg == "--out" && i + 1 < argc)
+				out_path = argv[++i];
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		// the value was not a number, or was out of range
+		printUsage();
+		return 1;
+	}
+
+	std::vector<BenchmarkResult> results;
+
+	for (const Scene& scene : scenes())
+		results.push_back(runScene(scene, size, frames, threads));
+
+	// ansiCode() is called about once per changed cell, so it is given the same number of iterations as there are cells in the scenes.
+	// the per cell values are per call in this case.
+	results.push_back(runAnsiCode((size_t)size.x * size.y * frames));
+
+	if (out_path.empty())
+	{
+		writeJson(std::cout, size, frames, threads, results);
+	}
+	else
+	{
+		std::ofstream out(out_path);
+
+		if (!out.is_open())
+		{
+			std::cerr << "could not open output file " << out_path << '\n';
+			return 1;
+		}
+
+		writeJson(out, size, frames, threads, results);
+	}
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include <pch/arpch.h>
+#include <Asciir/Rendering/FrameCapture.h>
+
+/// @brief tool for replaying capture files written by TerminalRendererInterface::startCapture()
+///
+/// the captured frames are written to the terminal, or any other file, without the application, input or shaders being involved,
+/// so the replay only measures the time it takes to write the frames.
+///
+/// usage:
+/// > ARReplay <capture file> [--out <file>] [--realtime] [--loops <n>]
+///
+/// --out		write the frames to the passed file instead of the terminal, e.g. /dev/null (NUL on windows) for measuring the write overhead only.
+/// --realtime	write each frame at the time it was captured, instead of as fast as possible.
+/// --loops		replay the capture n times, n must be greater than 0.
+///
+/// when the replay has finished, the number of frames, bytes and the achieved throughput is printed to stderr.
+///
+
+static void printUsage()
+{
+	std::cerr << "usage: ARReplay <capture file> [--out <file>] [--realtime] [--loops <n>]\n";
+}
+
+// parses the entire string as an integer in the range [min, max], throws on failure
+static long long parseInt(const std::string& str, long long min, long long max)
+{
+	size_t parsed = 0;
+	long long value = std::stoll(str, &parsed);
+
+	if (parsed != str.size() || value < min || value > max)
+		throw std::out_of_range("argument out of range: " + str);
+
+	return value;
+}
+
+int main(int argc, char** argv)
+{
+	std::filesystem::path capture_path;
+	std::filesystem::path out_path;
+	bool realtime = false;
+	size_t loops = 1;
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
+
+			if (arg == "--out" && i + 1 < argc)
+				out_path = argv[++i];
+			else if (arg == "--realtime")
+				realtime = true;
+			else if (arg == "--loops" && i + 1 < argc)
+				loops = (size_t)parseInt(argv[++i], 1, std::numeric_limits<long long>::max());
+			else if (capture_path.empty() && arg.rfind("--", 0) != 0)
+				capture_path = arg;
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		// the loop count was not a number, or was out of range
+		printUsage();
+		return 1;
+	}
+
+	if (capture_path.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	Asciir::CaptureReader reader(capture_path);
+
+	if (!reader.isOpen())
+	{
+		std::cerr << "could not read capture file " << capture_path << '\n';
+		return 1;
+	}
+
+	FILE* out = stdout;
+
+	if (!out_path.empty())
+	{
+		out = fopen(out_path.string().c_str(), "wb");
+
+		if (!out)
+		{
+			std::cerr << "could not open output file " << out_path << '\n';
+			return 1;
+		}
+	}
+
+	Asciir::CaptureFrame frame;
+	size_t frame_count = 0;
+	size_t byte_count = 0;
+	Asciir::DeltaTime capture_length;
+
+	Asciir::DeltaTime replay_start = Asciir::getTime();
+
+	for (size_t loop = 0; loop < loops; loop++)
+	{
+		Asciir::DeltaTime loop_start = Asciir::getTime();
+
+		while (reader.next(frame))
+		{
+			if (realtime)
+			{
+				Asciir::DeltaTime elapsed = Asciir::getTime() - loop_start;
+
+				if (elapsed < frame.time)
+					Asciir::sleep(frame.time - elapsed);
+			}
+
+			// each frame is flushed on its own, the same way the TerminalRenderer writes it
+			fwrite(frame.data.data(), 1, frame.data.size(), out);
+			fflush(out);
+
+			frame_count++;
+			byte_count += frame.data.size();
+			capture_length = frame.time;
+		}
+
+		reader.rewind();
+	}
+
+	Asciir::DeltaTime replay_time = Asciir::getTime() - replay_start;
+
+	if (out != stdout)
+		fclose(out);
+	else
+		std::cout << "\x1b[0m\x1b[?25h\n";
+
+	std::cerr << "frames:     " << frame_count << '\n'
+		<< "bytes:      " << byte_count << '\n'
+		<< "capture:    " << capture_length.seconds() * loops << "s\n"
+		<< "replay:     " << replay_time.seconds() << "s\n"
+		<< "frame rate: " << frame_count / replay_time.seconds() << " fps\n"
+		<< "throughput: " << byte_count / replay_time.seconds() / (1024 * 1024) << " MiB/s\n";
+
+	return 0;
+}
@@ -18,15 +18,40 @@ class LightningShader : public Shader2D
 	{
 		Coord uv = toUV(coord);
 
-		Colour background;
-
 		// the noise used is OpenSimplex 2, the closer the uv coords are to the edge of the screen, the closer to 0 the rng values will be.
 
 		// uncomment dead code if the "wobble" should reduce the closer the lightning comes to the terminal edges.
 		Real rng = /*std::min(1_R, 2*std::pow(std::sin(_uv.x * PI), 2_R)) * */noise_generator->GenSingle2D(uv.x, time_since_start, seed);
 
+		return gradient(uv.y, rng);
+	}
+
+	// the noise only depends on the column, so the noise for the entire span is generated with a single batched call.
+	virtual void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& time_since_start, size_t frames_since_start, Tile* out) override
+	{
+		TInt count = x_end - x_begin;
+
+		std::vector<float> x_pos(count);
+		std::vector<float> y_pos(count, (float)(Real)time_since_start);
+		std::vector<float> rng(count);
+
+		for (TInt i = 0; i < count; i++)
+			x_pos[i] = (float)toUV(TermVert(x_begin + i, y)).x;
+
+		noise_generator->GenPositionArray2D(rng.data(), count, x_pos.data(), y_pos.data(), 0, 0, seed);
+
+		Real uv_y = toUV(TermVert(x_begin, y)).y;
+
+		for (TInt i = 0; i < count; i++)
+			out[i] = gradient(uv_y, rng[i]);
+	}
+
+	Tile gradient(Real uv_y, Real rng)
+	{
+		Colour background;
+
 		// this generates a generate starting at the centre of the screen that expands horizontally
-		Real scale = (1 - (Real)std::pow(std::tanh(uv.y * 4 - 2 + 0.25 * rng), 2));
+		Real scale = (1 - (Real)std::pow(std::tanh(uv_y * 4 - 2 + 0.25 * rng), 2));
 
 		// colour the gradient, and make sure it is white in the centre
 
@@ -81,6 +106,61 @@ public:
 			return Tile::emptyTile();
 	}
 
+	// reads the rows of the wrapped shader above, at and below the span once, instead of reading up to 10 tiles for every tile in the span.
+	virtual void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& time_since_start, size_t frames_since_start, Tile* out) override
+	{
+		Quad shader_quad = Quad::fromCorners(Coord(1, 1), (Coord)m_shader->size());
+
+		// each row has an extra tile on both sides of the span.
+		TInt width = x_end - x_begin + 2;
+
+		std::vector<Tile> rows[3];
+		std::vector<char> inside[3];
+
+		for (TInt r = 0; r < 3; r++)
+		{
+			TInt row_y = y + r - 1;
+
+			rows[r].resize(width, Tile::emptyTile());
+			inside[r].resize(width);
+
+			// the shader quad is a rectangle, so the tiles inside it are always a single run.
+			TInt first = width;
+			TInt last = 0;
+
+			for (TInt i = 0; i < width; i++)
+			{
+				inside[r][i] = shader_quad.isInsideGrid(TermVert(x_begin - 1 + i, row_y));
+
+				if (inside[r][i])
+				{
+					first = std::min(first, i);
+					last = i + 1;
+				}
+			}
+
+			if (first < last)
+				m_shader->readSpan(row_y - 1, x_begin - 2 + first, x_begin - 2 + last, 0, 0, rows[r].data() + first);
+		}
+
+		for (TInt i = 1; i < width - 1; i++)
+		{
+			Tile& result = out[i - 1];
+
+			if (inside[1][i])
+				result = rows[1][i];
+			else
+				result = Tile::emptyTile();
+
+			// check if any of the neighbouring tiles exists, if they do, and you are on an empty tile, fill it with the outline tile.
+			if (!inside[1][i] || rows[1][i].background_colour.alpha == 0)
+				for (TInt r = 0; r < 3; r++)
+					for (TInt x = i - 1; x <= i + 1; x++)
+						if (inside[r][x] && rows[r][x].background_colour.alpha > 0)
+							result = m_outline;
+		}
+	}
+
 protected:
 	Ref<Shader2D> m_shader;
 	Tile m_outline;
@@ -90,6 +90,57 @@ class Mandelbrod : public Shader2D
 
 		return Colour(255);
 	}
+
+	// same as readTile, but iterates 8 points of the row at once, so the compiler can vectorize the inner loop.
+	void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime&, size_t, Tile* out) final override
+	{
+		constexpr TInt lanes = 8;
+		size_t maxIterations = 100;
+
+		Real cy = y / (Real)size().y;
+
+		for (TInt lane_begin = x_begin; lane_begin < x_end; lane_begin += lanes)
+		{
+			Real cx[lanes];
+			Real zx[lanes] = {};
+			Real zy[lanes] = {};
+			size_t escaped[lanes];
+
+			for (TInt l = 0; l < lanes; l++)
+			{
+				cx[l] = (lane_begin + l) / (Real)size().x;
+				escaped[l] = maxIterations;
+			}
+
+			for (size_t i = 0; i < maxIterations; i++)
+			{
+				bool all_escaped = true;
+
+				for (TInt l = 0; l < lanes; l++)
+				{
+					Real new_x = zx[l] * zx[l] - zy[l] * zy[l] + cx[l];
+					zy[l] = 2 * zx[l] * zy[l] + cy;
+					zx[l] = new_x;
+
+					if (escaped[l] == maxIterations && std::sqrt(zx[l] * zx[l] + zy[l] * zy[l]) > 2)
+						escaped[l] = i;
+
+					all_escaped &= escaped[l] != maxIterations;
+				}
+
+				if (all_escaped)
+					break;
+			}
+
+			for (TInt l = 0; l < lanes && lane_begin + l < x_end; l++)
+			{
+				if (escaped[l] != maxIterations)
+					out[lane_begin + l - x_begin] = Tile(Colour(((Real)escaped[l] / (Real)maxIterations) * 255));
+				else
+					out[lane_begin + l - x_begin] = Colour(255);
+			}
+		}
+	}
 };
 
 class TextureLayer : public Asciir::Layer
@@ -10,6 +10,7 @@
 #include "Asciir/Core/Terminal.h"
 #include "Asciir/Core/Timing.h"
 #include "Asciir/Core/Layer.h"
+#include "Asciir/Core/WorkerPool.h"
 // Core
 
 #include "Asciir/Logging/Log.h"
@@ -50,7 +51,7 @@
 #include "Asciir/Platform/Windows/WindowsARAttributes.h"
 #include "Asciir/Platform/Windows/WinInit.h"
 #elif defined(AR_UNIX)
-#include "Asciir/Platform/Unix/UnixARAttributes.h"
+#include "Asciir/Platform/Unix/UnixInit.h"
 #endif
 
 // tools
@@ -16,7 +16,7 @@
 namespace Asciir
 {
 	ARApp::ARApp(const std::string& title, TermVert term_size)
-		: m_render_thread(&ARApp::render, this), m_terminal_renderer(TerminalRenderer::TerminalProps(title, term_size))
+		: m_terminal_renderer(TerminalRenderer::TerminalProps(title, term_size)), m_render_thread([this](uint32_t) { render(); })
 	{
 		m_terminal_evt.setEventCallback(AR_TO_EVENT_CALLBACK(onEvent));
 	}
@@ -45,7 +45,7 @@ namespace Asciir
 
 		m_last_frame_start = m_app_start;
 
-		m_render_thread.start();
+		m_render_thread.resize(1);
 		
 		// start the main loop
 		run();
@@ -76,7 +76,7 @@ namespace Asciir
 				system->run(&*m_scene);
 
 			// wait for rendering to finish
-			m_render_thread.joinLoop();
+			m_render_thread.wait();
 			m_last_frame_start = curr_frame_start;
 			m_frame_count++;
 
@@ -84,7 +84,7 @@ namespace Asciir
 			Renderer::swapQueues();
 
 			// begin rendering next frame
-			m_render_thread.startLoop();
+			m_render_thread.dispatch();
 
 			CT_MEASURE_N("WAIT");
 
@@ -175,7 +175,7 @@ namespace Asciir
 
 	// signal requires the function to be static,
 	// so we need to have static acsess to the app for onTerminalClosed event
-	ARApp* const ARApp::getApplication()
+	ARApp* ARApp::getApplication()
 	{
 		return i_app;
 	}
@@ -6,6 +6,7 @@
 #include "Asciir/Event/TerminalEvent.h"
 #include "Asciir/Entities/ECS.h"
 #include "LayerStack.h"
+#include "WorkerPool.h"
 
 #include <ETH.h>
 
@@ -102,7 +103,7 @@ namespace Asciir
 		static void load(ARApp* app);
 
 		/// @brief get the main asciir application
-		static ARApp* const getApplication();
+		static ARApp* getApplication();
 
 		/// @brief get the terminal event handler tied to the main application
 		TerminalEventHandler& getTermEvtHandler();
@@ -146,8 +147,8 @@ namespace Asciir
 		size_t m_frame_count = 0;
 
 		/// @brief the seperate thread from which the terminal is rendered from
-		/// thread gets started every time an update is finished, unless a thread already is running
-		ETH::LThread m_render_thread;
+		/// thread gets dispatched every time an update is finished, after the previous render has finished
+		WorkerPool m_render_thread;
 
 		/// @brief stores the currently active application
 		static ARApp* i_app;
@@ -34,6 +34,8 @@ namespace Asciir
 		//Ref(const T& data) : std::shared_ptr<T>(std::make_shared<T>(data)) {}
 		/// @brief copy constructor
 		Ref(const Ref<T>& other) : std::shared_ptr<T>(other) {}
+		/// @brief copy assignment
+		Ref<T>& operator=(const Ref<T>& other) = default;
 		/// @brief convert shared_ptr to Ref 
 		Ref(const std::shared_ptr<T> other) : std::shared_ptr<T>(other) {}
 
@@ -73,6 +75,9 @@ namespace Asciir
 
 		using std::shared_ptr<T>::operator=;
 
+		/// @brief releases the referenced object, same as reset()
+		Ref<T>& operator=(std::nullptr_t) { this->reset(); return *this; }
+
 		/// @brief compare the value of two references
 		bool operator==(const Ref<T>& other) { return this->get() == other->get(); }
 	};
@@ -0,0 +1,299 @@
+#include "arpch.h"
+#include "WorkerPool.h"
+#include "Asciir/Logging/Log.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define AR_HAS_PAUSE
+#endif
+
+#if defined(AR_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#elif !defined(AR_WIN)
+#include <condition_variable>
+#endif
+
+namespace Asciir
+{
+	// the bounds of the adaptive spin time, in nanoseconds
+	static constexpr long long MIN_SPIN_TIME = 1000;
+	static constexpr long long MAX_SPIN_TIME = 100000;
+	static constexpr long long INITIAL_SPIN_TIME = 20000;
+
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "the futex functions require a std::atomic<uint32_t> to have the same layout as an uint32_t");
+
+#if defined(AR_WIN)
+
+	// blocks until word is woken, returns immediately if word is not equal to expected.
+	// may also return spuriously.
+	static void futexWait(std::atomic<uint32_t>& word, uint32_t expected)
+	{
+		WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+	}
+
+	// wakes all threads waiting on word
+	static void futexWake(std::atomic<uint32_t>& word)
+	{
+		WakeByAddressAll(&word);
+	}
+
+#elif defined(AR_LINUX)
+
+	static void futexWait(std::atomic<uint32_t>& word, uint32_t expected)
+	{
+		syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+	}
+
+	static void futexWake(std::atomic<uint32_t>& word)
+	{
+		syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+	}
+
+#else
+
+	// no futex is available, so fall back to a condition variable, shared by every waiting thread.
+	static std::mutex s_futex_mutex;
+	static std::condition_variable s_futex_cond;
+
+	static void futexWait(std::atomic<uint32_t>& word, uint32_t expected)
+	{
+		std::unique_lock<std::mutex> lock(s_futex_mutex);
+		s_futex_cond.wait(lock, [&]() { return word.load() != expected; });
+	}
+
+	static void futexWake(std::atomic<uint32_t>&)
+	{
+		// the waiter either checked the word before it was changed, and is now waiting, or it will see the new value.
+		{ std::lock_guard<std::mutex> lock(s_futex_mutex); }
+		s_futex_cond.notify_all();
+	}
+
+#endif
+
+	static long long timeNow()
+	{
+		return std::chrono::duration_cast<duration>(clock::now().time_since_epoch()).count();
+	}
+
+	static void cpuRelax()
+	{
+	#ifdef AR_HAS_PAUSE
+		_mm_pause();
+	#else
+		std::this_thread::yield();
+	#endif
+	}
+
+	// spins until done() returns true, or the spin time has passed.
+	// the spin time is doubled if done() returned true, and halved otherwise, so threads only keep spinning if it tends to succeed.
+	template<typename TDone>
+	static bool spinUntil(TDone done, long long& spin_time)
+	{
+		long long start = timeNow();
+
+		for (uint32_t i = 0;; i++)
+		{
+			if (done())
+			{
+				spin_time = std::min(spin_time * 2, MAX_SPIN_TIME);
+				return true;
+			}
+
+			cpuRelax();
+
+			// reading the clock is a lot slower than a pause, so it is only done once in a while.
+			if (i % 64 == 63 && timeNow() - start > spin_time)
+			{
+				spin_time = std::max(spin_time / 2, MIN_SPIN_TIME);
+				return false;
+			}
+		}
+	}
+
+	WorkerPool::WorkerPool(std::function<void(uint32_t)> job, uint32_t thread_count)
+		: m_job(job), m_wait_spin_time(INITIAL_SPIN_TIME)
+	{
+		resize(thread_count);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		stop();
+	}
+
+	void WorkerPool::resize(uint32_t thread_count)
+	{
+		AR_ASSERT_MSG(m_remaining.load() == 0, "WorkerPool cannot be resized whilst a job is running");
+
+		stop();
+
+		m_size = thread_count;
+		m_workers = std::make_unique<Worker[]>(thread_count);
+
+		for (uint32_t i = 0; i < thread_count; i++)
+		{
+			m_workers[i].spin_time = INITIAL_SPIN_TIME;
+			m_workers[i].thread = std::thread(&WorkerPool::workerLoop, this, i);
+		}
+	}
+
+	void WorkerPool::dispatch(uint32_t count)
+	{
+		AR_ASSERT_MSG(count <= m_size, "Cannot dispatch ", count, " workers, the pool only has ", m_size, " workers");
+		AR_ASSERT_MSG(m_remaining.load() == 0, "dispatch() was called before the previous dispatch finished, call wait() first");
+
+		if (count == 0)
+			return;
+
+		m_remaining.store(count, std::memory_order_relaxed);
+		m_dispatch_time.store(timeNow(), std::memory_order_relaxed);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Worker& worker = m_workers[i];
+
+			// the worker sets parked before it checks the epoch a final time, so either the worker sees the new epoch, or this sees parked.
+			worker.epoch.fetch_add(1);
+
+			if (worker.parked.load())
+				futexWake(worker.epoch);
+		}
+	}
+
+	void WorkerPool::wait()
+	{
+		if (spinUntil([&]() { return m_remaining.load(std::memory_order_acquire) == 0; }, m_wait_spin_time))
+			return;
+
+		uint32_t remaining;
+
+		while (true)
+		{
+			m_waiting.store(true);
+
+			if ((remaining = m_remaining.load()) == 0)
+				break;
+
+			futexWait(m_remaining, remaining);
+		}
+
+		m_waiting.store(false, std::memory_order_relaxed);
+	}
+
+	std::vector<WorkerPool::WorkerMetrics> WorkerPool::getMetrics() const
+	{
+		std::vector<WorkerMetrics> metrics(m_size);
+
+		for (uint32_t i = 0; i < m_size; i++)
+		{
+			const Worker& worker = m_workers[i];
+
+			metrics[i].jobs = worker.jobs.load(std::memory_order_relaxed);
+			metrics[i].parks = worker.parks.load(std::memory_order_relaxed);
+			metrics[i].wake_latency = duration(worker.wake_latency.load(std::memory_order_relaxed));
+			metrics[i].max_wake_latency = duration(worker.max_wake_latency.load(std::memory_order_relaxed));
+			metrics[i].idle_time = duration(worker.idle_time.load(std::memory_order_relaxed));
+			metrics[i].busy_time = duration(worker.busy_time.load(std::memory_order_relaxed));
+		}
+
+		return metrics;
+	}
+
+	void WorkerPool::resetMetrics()
+	{
+		for (uint32_t i = 0; i < m_size; i++)
+		{
+			Worker& worker = m_workers[i];
+
+			worker.jobs.store(0, std::memory_order_relaxed);
+			worker.parks.store(0, std::memory_order_relaxed);
+			worker.wake_latency.store(0, std::memory_order_relaxed);
+			worker.max_wake_latency.store(0, std::memory_order_relaxed);
+			worker.idle_time.store(0, std::memory_order_relaxed);
+			worker.busy_time.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void WorkerPool::workerLoop(uint32_t index)
+	{
+		Worker& worker = m_workers[index];
+		uint32_t seen = 0;
+
+		while (true)
+		{
+			long long idle_start = timeNow();
+
+			seen = awaitJob(worker, seen);
+
+			if (m_stopping.load(std::memory_order_acquire))
+				break;
+
+			long long job_start = timeNow();
+
+			// only this worker writes its metrics, so the maximum does not need a compare exchange loop.
+			uint64_t latency = (uint64_t)std::max(job_start - m_dispatch_time.load(std::memory_order_relaxed), 0LL);
+
+			worker.wake_latency.fetch_add(latency, std::memory_order_relaxed);
+			worker.idle_time.fetch_add(job_start - idle_start, std::memory_order_relaxed);
+
+			if (latency > worker.max_wake_latency.load(std::memory_order_relaxed))
+				worker.max_wake_latency.store(latency, std::memory_order_relaxed);
+
+			m_job(index);
+
+			worker.busy_time.fetch_add(timeNow() - job_start, std::memory_order_relaxed);
+			worker.jobs.fetch_add(1, std::memory_order_relaxed);
+
+			// the last worker to finish wakes wait(), if it is sleeping.
+			if (m_remaining.fetch_sub(1) == 1 && m_waiting.load())
+				futexWake(m_remaining);
+		}
+	}
+
+	uint32_t WorkerPool::awaitJob(Worker& worker, uint32_t seen)
+	{
+		uint32_t epoch = seen;
+
+		if (spinUntil([&]() { return (epoch = worker.epoch.load(std::memory_order_acquire)) != seen; }, worker.spin_time))
+			return epoch;
+
+		worker.parks.fetch_add(1, std::memory_order_relaxed);
+
+		while (true)
+		{
+			worker.parked.store(true);
+
+			if ((epoch = worker.epoch.load()) != seen)
+				break;
+
+			futexWait(worker.epoch, seen);
+		}
+
+		worker.parked.store(false, std::memory_order_relaxed);
+
+		return epoch;
+	}
+
+	void WorkerPool::stop()
+	{
+		if (m_size == 0)
+			return;
+
+		m_stopping.store(true, std::memory_order_release);
+
+		for (uint32_t i = 0; i < m_size; i++)
+		{
+			m_workers[i].epoch.fetch_add(1);
+			futexWake(m_workers[i].epoch);
+		}
+
+		for (uint32_t i = 0; i < m_size; i++)
+			m_workers[i].thread.join();
+
+		m_stopping.store(false, std::memory_order_relaxed);
+
+		m_workers.reset();
+		m_size = 0;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Core.h"
+#include "Timing.h"
+
+namespace Asciir
+{
+	/// @brief a fixed set of threads, which are kept alive between jobs, and run the same job function every time they are dispatched.
+	///
+	/// a dispatch wakes the first n workers, which each call the job function with their worker index.
+	/// wait() blocks until every dispatched worker has returned from the job function.
+	///
+	/// an idle worker first spins for a short time, in case the next job arrives soon, and then goes to sleep on its own epoch counter,
+	/// using a futex (WaitOnAddress on windows), until dispatch() increments the counter.
+	/// the spin time adapts to how often it succeeds, so workers that are always woken long after they finished, quickly stop spinning.
+	///
+	/// completion is signaled through a single countdown, which wait() spins and sleeps on in the same way.
+	///
+	/// the time it takes for each worker to wake up, and how much time it spends idle and working, are measured, @see getMetrics().
+	///
+	/// @note dispatch() and wait() should only be called from a single thread at a time.
+	///
+	class WorkerPool
+	{
+	public:
+		/// @brief timing measurements of a single worker, accumulated since the last resetMetrics() call.
+		struct WorkerMetrics
+		{
+			/// @brief the number of jobs the worker has run.
+			size_t jobs = 0;
+			/// @brief the number of times the worker went to sleep, instead of recieving the next job whilst spinning.
+			size_t parks = 0;
+			/// @brief the total time from dispatch() was called, until the worker started the job.
+			DeltaTime wake_latency;
+			/// @brief the longest time from dispatch() was called, until the worker started the job.
+			DeltaTime max_wake_latency;
+			/// @brief the total time the worker spent waiting for a job, spinning or sleeping.
+			DeltaTime idle_time;
+			/// @brief the total time the worker spent running jobs.
+			DeltaTime busy_time;
+		};
+
+		/// @brief constructs a pool without any workers, @see resize().
+		/// @param job the function each worker runs when dispatched, it is passed the index of the worker.
+		WorkerPool(std::function<void(uint32_t)> job, uint32_t thread_count = 0);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/// @brief stops all the current workers, and starts thread_count new workers.
+		/// @note must not be called whilst a job is running.
+		void resize(uint32_t thread_count);
+		/// @brief returns the number of workers in the pool.
+		uint32_t size() const { return m_size; }
+
+		/// @brief runs the job function on the first count workers.
+		/// @note the previous dispatch must have finished, @see wait().
+		void dispatch(uint32_t count);
+		/// @brief same as dispatch(size())
+		void dispatch() { dispatch(m_size); }
+		/// @brief blocks until all the workers of the last dispatch have finished their job.
+		/// returns immediately if nothing has been dispatched.
+		void wait();
+
+		/// @brief retrieves the metrics of every worker.
+		/// can be called from any thread, but the metrics of a worker currently running a job might be partially updated.
+		std::vector<WorkerMetrics> getMetrics() const;
+		/// @brief sets the metrics of every worker to 0.
+		/// @note increments made by a running job whilst the metrics are reset may be lost, to measure an interval whilst jobs are running, use the difference between two getMetrics() calls.
+		void resetMetrics();
+
+	protected:
+		struct alignas(64) Worker
+		{
+			/// @brief incremented by dispatch(), the worker sleeps on this value whilst idle.
+			std::atomic<uint32_t> epoch = 0;
+			/// @brief true if the worker might be sleeping, so dispatch() only makes a system call if it is needed.
+			std::atomic<bool> parked = false;
+			/// @brief the current spin time of the worker, in nanoseconds. only accessed by the worker itself.
+			long long spin_time;
+
+			std::atomic<uint64_t> jobs = 0;
+			std::atomic<uint64_t> parks = 0;
+			std::atomic<uint64_t> wake_latency = 0;
+			std::atomic<uint64_t> max_wake_latency = 0;
+			std::atomic<uint64_t> idle_time = 0;
+			std::atomic<uint64_t> busy_time = 0;
+
+			std::thread thread;
+		};
+
+		/// @brief main function of each worker thread.
+		void workerLoop(uint32_t index);
+		/// @brief returns the new epoch of the worker, once it differs from seen.
+		uint32_t awaitJob(Worker& worker, uint32_t seen);
+		/// @brief stops and joins all the workers.
+		void stop();
+
+		std::function<void(uint32_t)> m_job;
+
+		std::unique_ptr<Worker[]> m_workers;
+		uint32_t m_size = 0;
+
+		/// @brief the number of workers of the current dispatch, which have not finished their job yet.
+		std::atomic<uint32_t> m_remaining = 0;
+		/// @brief true if wait() might be sleeping on m_remaining.
+		std::atomic<bool> m_waiting = false;
+		/// @brief the spin time of wait(), in nanoseconds.
+		long long m_wait_spin_time;
+		/// @brief the time of the last dispatch() call, in nanoseconds since the clock epoch.
+		std::atomic<long long> m_dispatch_time = 0;
+		std::atomic<bool> m_stopping = false;
+	};
+}
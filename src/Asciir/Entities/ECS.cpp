@@ -132,12 +132,12 @@ namespace Asciir
     SceneView::SceneView(Scene& target_scene)
         : m_scene(target_scene) {}
 
-    typename ComponentIterator SceneView::begin()
+    ComponentIterator SceneView::begin()
     {
         return ComponentIterator(this);
     }
 
-    typename ComponentIterator SceneView::end()
+    ComponentIterator SceneView::end()
     {
         if (m_target_component_buffer.index() == 1)
             return ComponentIterator(this, m_scene.componentCount(std::get<std::type_index>(m_target_component_buffer)));
@@ -173,7 +173,7 @@ namespace Asciir
     }
 
    ComponentIterator::ComponentIterator(SceneView* scene_view, size_t start_index)
-        : m_scene_view(scene_view), m_current_index(start_index)
+        : m_current_index(start_index), m_scene_view(scene_view)
     {
         findNextEntity();
     }
@@ -189,7 +189,7 @@ namespace Asciir
     {
         ComponentIterator prev = *this;
 
-        if(&m_scene_view->m_scene)
+        if(m_scene_view)
             ++* this;
        
         return prev;
@@ -566,7 +566,7 @@ namespace Asciir
 		Component& getComponentIndexed(size_t index, std::type_index component_type);
 
 		template<typename ... TComps>
-		SceneView getView() { return getView({ typeid(TComps)... }); };
+		SceneView getView() { return getView({ typeid(TComps)... }); }
 
 		/// @brief return a scene view with the specified component requirements.
 		SceneView getView(const std::unordered_set<std::type_index>& components);
@@ -675,7 +675,7 @@ namespace Asciir
 		template<typename ... TComps>
 		void add(const TComps& ... component_vals)
 		{
-			m_scene->addComponents<TComp, Rest...>(getID(), component_vals...);
+			m_scene->addComponents<TComps...>(getID(), component_vals...);
 		}
 
 		/// @brief removes the speciffied component(s) from the entity.
@@ -132,8 +132,8 @@ namespace Asciir
 
 #ifdef AR_WIN
 	#include "Asciir/Platform/Windows/WinEventListener.h"
-#elif defined(AR_MAC)
-#elif defined(AR_LINUX)
+#elif defined(AR_UNIX)
+	#include "Asciir/Platform/Unix/UnixEventListener.h"
 #else
 #error platform not specified, unable to decide on interface implementaion for EventListener
 #endif
@@ -10,7 +10,8 @@
 namespace Asciir
 {
 	// TODO: inline?
-	TermVert Input::s_mouse_pos, Input::s_mouse_diff, Input::s_last_terminal_pos;
+	TermVert Input::s_mouse_pos, Input::s_mouse_diff;
+	Coord Input::s_last_terminal_pos;
 	TermVert Input::s_last_size, Input::s_cur_pos, Input::s_cur_diff;
 	TerminalRenderer::TRUpdateInfo Input::s_info;
 	EventListener* Input::s_event_listener = nullptr;
@@ -129,7 +129,7 @@ namespace Asciir
 		static void setEventListener(EventListener& listener);
 
 		static TermVert s_mouse_pos, s_mouse_diff;
-		static TermVert s_last_terminal_pos;
+		static Coord s_last_terminal_pos;
 		static TermVert s_last_size;
 		static TermVert s_cur_pos, s_cur_diff;
 		static TerminalEventHandler* i_terminal;
@@ -55,7 +55,7 @@
 		AR_DEBUG_BREAK; \
 	}}
 #else
-#define AR_VERIFY_MSG(x, ...) {x;}
+#define AR_VERIFY_MSG(x, ...) {(void)(x);}
 #endif
 
 /// @brief verifies function passed (x)
@@ -64,7 +64,7 @@
 #ifdef AR_DEBUG
 #define AR_VERIFY(x) AR_VERIFY_MSG(x, "Verify failed!")
 #else
-#define AR_VERIFY(x) {x;}
+#define AR_VERIFY(x) {(void)(x);}
 #endif
 
 /// @brief same as AR_VERIFY_MSG
@@ -108,4 +108,4 @@
 #define AR_ASSERT_VOLATILE(x, ...) if(!(x)) { \
 	AR_CORE_ERR(__VA_ARGS__, " line: ", __LINE__, " File: ", __FILE__); \
 	AR_DEBUG_BREAK; \
-	assert((false && "Error message can be found in a log file"));}
\ No newline at end of file
+	assert((false && "Error message can be found in a log file"));}
@@ -24,7 +24,7 @@ namespace Asciir
 		milliseconds -= minutes * 1000 * 60;
 
 		Real seconds = (Real)milliseconds / 10;
-		seconds = round(seconds);
+		seconds = std::round(seconds);
 		seconds /= 100;
 
 		tmp_stream << '[' << log_level << ']';
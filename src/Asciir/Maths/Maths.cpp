@@ -2,7 +2,6 @@
 
 namespace Asciir
 {
-	const Real PI = (Real)M_PI;
 
 	bool compareMargin(Real a, Real b, Real margin)
 	{
@@ -5,7 +5,7 @@
 
 namespace Asciir
 {
-	const extern Real PI;
+	constexpr Real PI = (Real)3.14159265358979323846;
 
 	constexpr Real degToRad(Real degrees)
 	{
@@ -48,19 +48,19 @@ namespace Asciir
 	/// 
 	/// @param val the value to be rounded
 	/// @param base the base to be rounded in
-	Real round(Real val, Real base = 1);
+	Real round(Real val, Real base);
 	/// @brief rounds both x, and y value using the given base
 	/// see round(Real, Real) for implementation details
 	Coord round(const Coord& coord, Real base = 1);
 	/// @brief rounds the given value up to the nearest value divisible by base
 	/// see round(Real, Real) for implementation details
-	Real ceil(Real val, Real base = 1);
+	Real ceil(Real val, Real base);
 	/// @brief rounds the given Coord up to the nearest value divisible by base
 	/// see round(Real, Real) for implementation details
 	Coord ceil(const Coord& coord, Real base = 1);
 	/// @brief rounds the given value down to the nearest value divisible by base
 	/// see round(Real, Real) for implementation details
-	Real floor(Real val, Real base = 1);
+	Real floor(Real val, Real base);
 	/// @brief rounds the given Coord down to the nearest value divisible by base
 	/// see round(Real, Real) for implementation details
 	Coord floor(const Coord& coord, Real base = 1);
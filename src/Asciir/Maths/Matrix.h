@@ -34,8 +34,8 @@ namespace Asciir
 		/// @brief returns the 2D size of the array (the dimentions)
 		Size2D dim() const;
 
-		size_t width() const { return cols(); }
-		size_t height() const{ return rows(); }
+		size_t width() const { return this->cols(); }
+		size_t height() const{ return this->rows(); }
 
 		/// @brief resize the matrix whilst preserving the data contained.
 		/// see resizeClear() for a faster but more destructive resize.
@@ -38,9 +38,9 @@ namespace Asciir
 	template<typename T>
 	T& arTensor3D<T>::get(Size3D index)
 	{
-		AR_ASSERT_MSG(index.x < size().x&& index.y < size().y&& index.z < size().z, "Index out of bounds: ", index, " bounds: ", size());
+		AR_ASSERT_MSG(index.x < dim().x&& index.y < dim().y&& index.z < dim().z, "Index out of bounds: ", index, " bounds: ", dim());
 
-		return arMatrix<T>::operator()(index.x * size().y + index.y, index.z);
+		return arMatrix<T>::operator()(index.x * dim().y + index.y, index.z);
 	}
 
 	template<typename T>
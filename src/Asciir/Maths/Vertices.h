@@ -5,6 +5,11 @@
 
 namespace Asciir
 {
+	// declared here as they are needed by arVertBase, see Maths.h for documentation
+	Real round(Real val, Real base = 1);
+	Real floor(Real val, Real base = 1);
+	Real ceil(Real val, Real base = 1);
+
 	/// @brief A base wrapper to be used as a base for arVertex<n>, arVertex2D and arVertex3D
 	/// @tparam the datatype to be stored
 	/// @tparam n the number of dimensions
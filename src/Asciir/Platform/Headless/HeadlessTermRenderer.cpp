@@ -0,0 +1,55 @@
+#include "HeadlessTermRenderer.h"
+
+#include "arpch.h"
+
+#include <ChrTrc.h>
+
+namespace Asciir
+{
+namespace TRInterface
+{
+	// ============ HeadlessTerminalRenderer ============
+
+	HeadlessTerminalRenderer::HeadlessTerminalRenderer(const HeadlessTerminalRenderer::TerminalProps& props)
+		: TerminalRendererInterface(props), m_size(props.size)
+	{
+		if (m_size == TermVert(0, 0))
+			m_size = TermVert(80, 24);
+
+		m_font_size = getFont().second;
+
+		initRenderer(props);
+	}
+
+	HeadlessTerminalRenderer::~HeadlessTerminalRenderer()
+	{
+		// the writer thread stores the frame in this object, so it must finish before the object is destroyed
+		waitForWriter();
+	}
+
+	TermVert HeadlessTerminalRenderer::maxSize() const
+	{
+		constexpr TInt max_int = std::numeric_limits<TInt>::max();
+		return TermVert(max_int, max_int);
+	}
+
+	void HeadlessTerminalRenderer::resizeBuff()
+	{
+		// there is no terminal to resize, so the fixed size simply becomes the requested size.
+		m_size = TermVert((TInt)drawWidth(), (TInt)drawHeight());
+	}
+
+	void HeadlessTerminalRenderer::flushBuffer(const char* data, size_t size)
+	{
+		CT_MEASURE_N("BUFFER FLUSH");
+
+		m_last_frame.assign(data, data + size);
+
+		m_total_bytes += size;
+		m_frame_count++;
+
+		if (m_write_rate > 0)
+			sleep(DeltaTime((Real)size / m_write_rate));
+	}
+}
+}
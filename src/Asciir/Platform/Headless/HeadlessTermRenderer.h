@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Asciir/Rendering/TerminalRenderer.h"
+
+namespace Asciir
+{
+namespace TRInterface
+{
+	/// @brief Headless implementation of TerminalRenderer.
+	/// renders into memory at a fixed size, without making any platform specific calls.
+	/// 
+	/// the encoded frame is never written anywhere, instead it is copied to a last frame buffer,
+	/// so it can be inspected after the draw call.
+	///
+	/// this is useful for running applications without a terminal attached (servers, CI),
+	/// as well as for measuring the rendering throughput, without the terminal influencing the results.
+	class HeadlessTerminalRenderer : public TerminalRendererInterface
+	{
+	public:
+		/// @brief constructs a headless renderer of the size passed in the TerminalProps.
+		/// if no size is passed, a size of 80x24 is used.
+		HeadlessTerminalRenderer(const HeadlessTerminalRenderer::TerminalProps& props);
+		~HeadlessTerminalRenderer();
+
+		/// @see TerminalRendererInterface::termSize()
+		/// @note returns the fixed size of the renderer, this only changes on a resize request.
+		TermVert termSize() const { return m_size; }
+		/// @see TerminalRendererInterface::maxSize()
+		TermVert maxSize() const;
+		/// @see TerminalRendererInterface::pos()
+		Coord pos() const { return Coord(0, 0); }
+
+		/// @see TerminalRendererInterface::resizeBuff()
+		void resizeBuff();
+
+		/// @see TerminalRendererInterface::getFont()
+		std::pair<std::string, Size2D> getFont() const { return { "", Size2D(0, 0) }; }
+
+		/// @see TerminalRendererInterface::setFont()
+		/// @note there is no font to set, so this always fails.
+		bool setFont(const std::string&, Size2D) { return false; }
+
+		/// @see TerminalRendererInterface::isFocused()
+		bool isFocused() const { return true; }
+
+		/// @see TerminalRendererInterface::flushBuffer()
+		void flushBuffer(const char* data, size_t size);
+
+		// the frame is stored by the writer thread, so the below functions wait for it to finish writing the last drawn frame, @see waitForWriter().
+
+		/// @brief returns the encoded ansi data of the last drawn frame.
+		const std::vector<char>& lastFrame() { waitForWriter(); return m_last_frame; }
+		/// @brief returns the number of bytes produced by the last drawn frame.
+		size_t lastFrameSize() { waitForWriter(); return m_last_frame.size(); }
+		/// @brief returns the total number of bytes produced since the renderer was constructed.
+		size_t totalBytes() { waitForWriter(); return m_total_bytes; }
+		/// @brief returns the number of frames drawn since the renderer was constructed.
+		size_t frameCount() { waitForWriter(); return m_frame_count; }
+
+		/// @brief simulates a slow terminal, or connection to it, by taking at least size / bytes_per_second seconds to write each frame.
+		/// 0 means no limit, which is the default.
+		/// @note should only be called when no frame is being written, e.g. after waitForWriter().
+		void setWriteRate(size_t bytes_per_second) { m_write_rate = bytes_per_second; }
+		/// @brief returns the simulated write rate, in bytes per second.
+		size_t getWriteRate() const { return m_write_rate; }
+
+	protected:
+		TermVert m_size;
+
+		std::vector<char> m_last_frame;
+		size_t m_total_bytes = 0;
+		size_t m_frame_count = 0;
+		size_t m_write_rate = 0;
+	};
+}
+
+typedef TRInterface::HeadlessTerminalRenderer TerminalRenderer;
+
+}
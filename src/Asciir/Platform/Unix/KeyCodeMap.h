@@ -1,10 +0,0 @@
-#pragma once
-
-#include "Asciir/Input/KeyCodes.h"
-
-namespace Asciir
-{
-    int keyCodeToUnix(Key code);
-
-    int mouseCodeToUnix(MouseKey code);
-}
@@ -6,23 +6,26 @@ namespace Asciir
 {
 namespace ELInterface
 {
-    class TerminalEventHandler;
+	/// @brief unix implementation of the EventListener class.
+	/// 
+	/// terminal input is not yet supported on unix, so this listener never sends any events,
+	/// and all polled key and mouse states will stay in their released state.
+	/// @see EventListenerImpl
+	class UnixEventListener : public EventListenerImpl
+	{
+	public:
+		/// @brief stores the callback, no events are currently sent to it.
+		/// @see EventListenerImpl::start()
+		void start(EventCallbackFp callback) { m_callback = callback; } // compiletime override
+		/// @see EventListenerImpl::stop()
+		void stop() { m_callback = nullptr; } // compiletime override
 
-    template<>
-    class EventListenerImpl<IMPLS::MAC>: public EventListenerImpl<IMPLS::INTER>
-    {
-    public:
+		/// @brief the mouse position is not tracked on unix, always returns (0, 0).
+		static TermVert getCurrentMousePos() { return { 0, 0 }; }
+	};
+}
 
-        void start(EventCallbackFp callback)
-        {}
-		
-        void stop()
-        {}
+/// @brief typedef of the currently implemented EventListenerImpl interface @see EventListenerImpl
+typedef ELInterface::UnixEventListener EventListener;
 
-        static Coord getCurrentMousePos()
-        {
-            return {};
-        }
-    };
 }
-}
\ No newline at end of file
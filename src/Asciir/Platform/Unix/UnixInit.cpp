@@ -0,0 +1,21 @@
+#include "arpch.h"
+#include "UnixInit.h"
+#include "Asciir/Logging/Log.h"
+
+#include <sys/resource.h>
+#include <errno.h>
+#include <cstring>
+
+namespace Asciir
+{
+	void LinuxInit()
+	{
+		// try to give the current process a higher priority.
+		// lowering the niceness requires elevated privileges, so failing here is expected and not an error.
+		errno = 0;
+		int niceness = getpriority(PRIO_PROCESS, 0);
+
+		if (errno == 0 && niceness > -10 && setpriority(PRIO_PROCESS, 0, -10) != 0)
+			AR_CORE_INFO("Could not raise process priority: ", strerror(errno));
+	}
+}
\ No newline at end of file
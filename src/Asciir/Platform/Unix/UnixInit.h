@@ -0,0 +1,8 @@
+#pragma once
+
+namespace Asciir
+{
+	/// @brief entry point for the linux specific implementation of Asciir.  
+	/// tries to raise the priority of the process, this is silently skipped if the user is not allowed to do so.
+	void LinuxInit();
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "UnixTermRenderer.h"
+
+#include "arpch.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <ChrTrc.h>
+
+#include "Asciir/Logging/Log.h"
+
+namespace Asciir
+{
+namespace TRInterface
+{
+	// begin and end synchronized update (DEC mode 2026)
+	static constexpr char SYNC_BEGIN[] = "\x1b[?2026h";
+	static constexpr char SYNC_END[] = "\x1b[?2026l";
+
+	// ============ TermRendererBuffer ============
+
+	TermRendererBuffer::TermRendererBuffer()
+	{
+		if (isatty(STDOUT_FILENO))
+		{
+			m_tty_fd = STDOUT_FILENO;
+		}
+		else
+		{
+			m_tty_fd = open("/dev/tty", O_WRONLY | O_NOCTTY | O_CLOEXEC);
+			m_owns_fd = m_tty_fd != -1;
+
+			// no controlling tty, just write to stdout, whatever it is.
+			if (!m_owns_fd)
+				m_tty_fd = STDOUT_FILENO;
+		}
+	}
+
+	TermRendererBuffer::~TermRendererBuffer()
+	{
+		if (m_owns_fd)
+			close(m_tty_fd);
+	}
+
+	void TermRendererBuffer::writeFrame(const char* data, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		// the frame is wrapped in the synchronized update sequence without copying it, using the io vectors.
+		iovec iov[3] = {
+			{ (void*)SYNC_BEGIN, sizeof(SYNC_BEGIN) - 1 },
+			{ (void*)data, size },
+			{ (void*)SYNC_END, sizeof(SYNC_END) - 1 }
+		};
+
+		writeAll(iov, 3);
+	}
+
+	void TermRendererBuffer::write(const char* data, size_t size)
+	{
+		iovec iov = { (void*)data, size };
+		writeAll(&iov, 1);
+	}
+
+	void TermRendererBuffer::writeAll(iovec* iov, int iov_count)
+	{
+		while (iov_count > 0)
+		{
+			ssize_t written = writev(m_tty_fd, iov, iov_count);
+
+			if (written < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				else if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					// the tty is not able to recieve more data at the moment, wait until it is.
+					pollfd pfd = { m_tty_fd, POLLOUT, 0 };
+					poll(&pfd, 1, -1);
+					continue;
+				}
+
+				AR_CORE_ERR("Failed to write frame to the tty: ", strerror(errno));
+				return;
+			}
+
+			// skip the io vectors that have been written entirely, and offset the partially written one.
+			while (iov_count > 0 && (size_t)written >= iov->iov_len)
+			{
+				written -= iov->iov_len;
+				iov++;
+				iov_count--;
+			}
+
+			if (iov_count > 0)
+			{
+				iov->iov_base = (char*)iov->iov_base + written;
+				iov->iov_len -= written;
+			}
+		}
+	}
+
+	// ============ UnixTerminalRenderer ============
+
+	UnixTerminalRenderer::UnixTerminalRenderer(const UnixTerminalRenderer::TerminalProps& props)
+		: TerminalRendererInterface(props)
+	{
+		m_is_tty = tcgetattr(m_buffer.getFD(), &m_fallback_termios) == 0;
+
+		if (m_is_tty)
+		{
+			// raw mode, except for signals and output processing.
+			// signals should still be generated on ctrl + c, and a newline should still move the cursor to the start of the next line.
+			termios raw = m_fallback_termios;
+
+			raw.c_iflag &= ~(IXON | ICRNL | BRKINT | INPCK | ISTRIP);
+			raw.c_lflag &= ~(ECHO | ICANON | IEXTEN);
+			raw.c_cflag |= CS8;
+
+			AR_VERIFY_MSG(tcsetattr(m_buffer.getFD(), TCSAFLUSH, &raw) == 0, "Failed to put the tty into raw mode");
+		}
+
+		// use alternate screen buffer
+		// makes sure the text on the terminal before the application was started is not modified by the program.
+		pushBuffer(AR_ANSI_CSI);
+		pushBuffer("?1049h");
+
+		m_font_size = getFont().second;
+
+		initRenderer(props);
+	}
+
+	UnixTerminalRenderer::~UnixTerminalRenderer()
+	{
+		// the last frame must be written before the terminal is restored
+		waitForWriter();
+
+		// reset the attributes, show the cursor and switch back to the main screen buffer
+		constexpr char reset_code[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+		m_buffer.write(reset_code, sizeof(reset_code) - 1);
+
+		if (m_is_tty)
+			tcsetattr(m_buffer.getFD(), TCSAFLUSH, &m_fallback_termios);
+	}
+
+	TermVert UnixTerminalRenderer::termSize() const
+	{
+		winsize size;
+
+		if (ioctl(m_buffer.getFD(), TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0)
+			return TermVert(size.ws_col, size.ws_row);
+
+		// the size could not be retrieved from the tty, fall back to the environment, and lastly the vt100 default size.
+		const char* cols = getenv("COLUMNS");
+		const char* rows = getenv("LINES");
+
+		if (cols && rows && atoi(cols) > 0 && atoi(rows) > 0)
+			return TermVert((TInt)atoi(cols), (TInt)atoi(rows));
+
+		return TermVert(80, 24);
+	}
+
+	TermVert UnixTerminalRenderer::maxSize() const
+	{
+		// no limits for maximum terminal size on unix systems
+		constexpr TInt max_int = std::numeric_limits<TInt>::max();
+		return TermVert(max_int, max_int);
+	}
+
+	void UnixTerminalRenderer::resizeBuff()
+	{
+		// request the terminal window to resize (xterm window manipulation).
+		// terminals not supporting this will ignore the sequence, in which case the renderer will simply resize to the terminal size on the next update.
+		pushBuffer(AR_ANSI_CSI);
+		pushBuffer("8;" + std::to_string(drawHeight()) + ';' + std::to_string(drawWidth()) + 't');
+	}
+
+	void UnixTerminalRenderer::flushBuffer(const char* data, size_t size)
+	{
+		CT_MEASURE_N("BUFFER FLUSH");
+		m_buffer.writeFrame(data, size);
+	}
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Asciir/Rendering/TerminalRenderer.h"
+
+#include <sys/uio.h>
+
+namespace Asciir
+{
+namespace TRInterface
+{
+	/// @detail the unix implementation of the TermRendererBuffer writes directly to the file descriptor of the tty.
+	///
+	/// a frame is written with a single writev call, wrapping the frame data in a synchronized update sequence, without copying it.
+	/// terminals supporting this will display the frame at once, terminals not supporting it will simply ignore the sequence.
+	///
+	class TermRendererBuffer
+	{
+	public:
+		/// @brief constructs a TermRendererBuffer instance, and opens the tty that should be written to.
+		///
+		/// if stdout is a tty, this will be used, otherwise the controlling tty of the process is opened.
+		/// if the process has no controlling tty (fx. when run as a service), stdout is used regardless.
+		TermRendererBuffer();
+		/// @brief closes the tty, if it was opened by the buffer.
+		~TermRendererBuffer();
+
+		/// @brief writes the passed frame to the tty, as a synchronized update.
+		void writeFrame(const char* data, size_t size);
+
+		/// @brief writes the passed data to the tty, as is.
+		void write(const char* data, size_t size);
+
+		/// @brief returns the file descriptor of the tty the buffer writes to.
+		int getFD() const { return m_tty_fd; }
+
+	protected:
+		/// @brief writes all the passed io vectors to the tty.
+		/// partial writes and interrupts are retried until all data has been written, or an unrecoverable error occurs.
+		void writeAll(iovec* iov, int iov_count);
+
+		int m_tty_fd = -1;
+		// the tty should only be closed, if it was opened by the buffer itself
+		bool m_owns_fd = false;
+	};
+
+	/// @brief Unix specific implementation of TerminalRenderer.
+	/// puts the tty into raw mode and writes the rendered frames directly to its file descriptor.
+	///
+	/// this implementation only makes use of POSIX functions and ansi escape sequences, meaning it does not need a display server,
+	/// and therefore also works on headless servers and over ssh.
+	class UnixTerminalRenderer : public TerminalRendererInterface
+	{
+	public:
+		/// @brief puts the tty into raw mode and switches to the alternate screen buffer.
+		UnixTerminalRenderer(const UnixTerminalRenderer::TerminalProps& props);
+		/// @brief reverts the tty to before UnixTerminalRenderer was instantiated
+		~UnixTerminalRenderer();
+
+		/// @see TerminalRendererInterface::termSize()
+		TermVert termSize() const;
+		/// @see TerminalRendererInterface::maxSize()
+		TermVert maxSize() const;
+		/// @see TerminalRendererInterface::pos()
+		/// @note a tty has no position, so this always returns (0, 0).
+		Coord pos() const { return Coord(0, 0); }
+
+		/// @see TerminalRendererInterface::resizeBuff()
+		void resizeBuff();
+
+		/// @see TerminalRendererInterface::getFont()
+		/// @note the font of a tty cannot be queried, so an empty name and size is returned.
+		std::pair<std::string, Size2D> getFont() const { return { "", Size2D(0, 0) }; }
+
+		/// @see TerminalRendererInterface::setFont()
+		/// @note the font of a tty cannot be modified, so this always fails.
+		bool setFont(const std::string&, Size2D) { return false; }
+
+		/// @see TerminalRendererInterface::isFocused()
+		/// @note focus is not reported by a tty, so it is always assumed to be focused.
+		bool isFocused() const { return true; }
+
+		/// @see TerminalRendererInterface::flushBuffer()
+		void flushBuffer(const char* data, size_t size);
+
+	protected:
+		TermRendererBuffer m_buffer;
+
+		// tty attributes before constructor
+		termios m_fallback_termios;
+		// false if the file descriptor is not a tty, in this case the attributes should not be modified.
+		bool m_is_tty = false;
+	};
+}
+
+typedef TRInterface::UnixTerminalRenderer TerminalRenderer;
+
+}
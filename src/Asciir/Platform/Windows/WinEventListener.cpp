@@ -2,7 +2,7 @@
 
 #include "WinEventListener.h"
 #include "KeyCodeMap.h"
-#include "WinTermRenderer.h"
+#include "Asciir/Rendering/TerminalRenderer.h"
 
 #include "Asciir/Event/KeyEvent.h"
 #include "Asciir/Event/MouseEvent.h"
@@ -14,11 +14,9 @@ namespace TRInterface
 {
 	// ============ TermRendererBuffer ============
 
-	TermRendererBuffer::TermRendererBuffer(size_t buffer_size)
+	TermRendererBuffer::TermRendererBuffer()
 		: m_console_hwin(GetConsoleWindow())
 	{
-		m_buffer.reserve(buffer_size);
-
 		// allocate console buffers
 		m_hconsole_display = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, FILE_SHARE_WRITE, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
 		m_hconsole_writable = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, FILE_SHARE_WRITE, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
@@ -32,56 +30,18 @@ namespace TRInterface
 		AR_WIN_VERIFY(SetConsoleActiveScreenBuffer(m_hconsole_display));
 	}
 
-	std::streamsize TermRendererBuffer::xsputn(const std::streambuf::char_type* s, std::streamsize count)
-	{
-		if (count + m_buffer.size() > m_buffer.capacity())
-			sync();
-
-		if ((size_t)count > m_buffer.capacity())
-		{
-			AR_WIN_VERIFY(WriteFile(m_hconsole_writable, m_buffer.c_str(), (DWORD) m_buffer.size(), NULL, NULL));
-			AR_WIN_VERIFY(WriteFile(m_hconsole_display, m_buffer.c_str(), (DWORD) m_buffer.size(), NULL, NULL));
-		}
-		else
-		{
-			m_buffer += s;
-		}
-
-		return count;
-	}
-
-	std::streambuf::int_type TermRendererBuffer::overflow(std::streambuf::int_type ch)
-	{
-		if (ch != std::streambuf::traits_type::eof())
-		{
-			if (m_buffer.size() == m_buffer.capacity())
-				sync();
-
-			m_buffer += (char)ch;
-
-			return 0;
-		}
-		else
-		{
-			return -1;
-		}
-	}
-
 	// this should be used sparingly in the windows implementation, as it write to both the writable and display buffer in order to sync the data.
-	int TermRendererBuffer::sync()
+	void TermRendererBuffer::write(const char* data, size_t size)
 	{
-		AR_WIN_VERIFY(WriteFile(m_hconsole_writable, m_buffer.c_str(), (DWORD) m_buffer.size(), NULL, NULL));
-		AR_WIN_VERIFY(WriteFile(m_hconsole_display, m_buffer.c_str(), (DWORD) m_buffer.size(), NULL, NULL));
-		m_buffer.clear();
-
-		return 0;
+		AR_WIN_VERIFY(WriteFile(m_hconsole_writable, data, (DWORD)size, NULL, NULL));
+		AR_WIN_VERIFY(WriteFile(m_hconsole_display, data, (DWORD)size, NULL, NULL));
 	}
 
-	void TermRendererBuffer::swapCBuffer()
+	void TermRendererBuffer::swapCBuffer(const char* data, size_t size)
 	{
 		{
 			CT_MEASURE_N("BWRITE 1");
-			AR_WIN_VERIFY(WriteFile(m_hconsole_writable, m_buffer.c_str(), (DWORD)m_buffer.size(), NULL, NULL));
+			AR_WIN_VERIFY(WriteFile(m_hconsole_writable, data, (DWORD)size, NULL, NULL));
 		}
 
 		std::swap(m_hconsole_writable, m_hconsole_display);
@@ -93,16 +53,14 @@ namespace TRInterface
 
 		{
 			CT_MEASURE_N("BWRITE 2");
-			AR_WIN_VERIFY(WriteFile(m_hconsole_writable, m_buffer.c_str(), (DWORD)m_buffer.size(), NULL, NULL));
+			AR_WIN_VERIFY(WriteFile(m_hconsole_writable, data, (DWORD)size, NULL, NULL));
 		}
-
-		m_buffer.clear();
 	}
 
 	// ============ WinTerminalRenderer ============
 
 	WinTerminalRenderer::WinTerminalRenderer(const WinTerminalRenderer::TerminalProps& props)
-		: TerminalRendererInterface(props), m_buffer(props.buffer_size), m_console(GetStdHandle(STD_OUTPUT_HANDLE)), m_console_hwin(GetConsoleWindow())
+		: TerminalRendererInterface(props), m_console(GetStdHandle(STD_OUTPUT_HANDLE)), m_console_hwin(GetConsoleWindow())
 	{
 		// enable ansi code support
 		AR_WIN_VERIFY(GetConsoleMode(m_console, &m_fallback_console_mode));
@@ -126,6 +84,8 @@ namespace TRInterface
 
 	WinTerminalRenderer::~WinTerminalRenderer()
 	{
+		// the last frame must be written before the console is restored
+		waitForWriter();
 
 		// reset console mode
 		//AR_WIN_VERIFY(SetConsoleMode(m_console, m_fallback_console_mode));
@@ -296,13 +256,13 @@ namespace TRInterface
 		return GetForegroundWindow() == GetConsoleWindow();
 	}
 
-	void WinTerminalRenderer::flushBuffer()
+	void WinTerminalRenderer::flushBuffer(const char* data, size_t size)
 	{
 		CT_MEASURE_N("BUFFER FLUSH");
 
 		{
 			CT_MEASURE_N("BUFFER SWAP");
-			m_buffer.swapCBuffer();
+			m_buffer.swapCBuffer(data, size);
 		}
 
 		{
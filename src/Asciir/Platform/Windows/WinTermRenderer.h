@@ -12,12 +12,11 @@ namespace TRInterface
 	/// the reason for this is that it is much faster to write to a console buffer that is not currently being displayed,
 	/// thus a buffer swap system is implemented with the console buffers, where each console print, will result in the buffers being swapped.
 	///
-	class TermRendererBuffer : public std::streambuf
+	class TermRendererBuffer
 	{
 	public:
 		/// @brief constructs a TermRendererBuffer instance
-		/// @param buffer_size the size of the buffer
-		TermRendererBuffer(size_t buffer_size);
+		TermRendererBuffer();
 
 		~TermRendererBuffer()
 		{
@@ -28,22 +27,13 @@ namespace TRInterface
 			AR_WIN_VERIFY(CloseHandle(m_hconsole_writable));
 		}
 
-		/// @brief put *s* into the buffer
-		/// @param s string data
-		/// @param count length of string data
-		/// @return count
-		std::streamsize xsputn(const std::streambuf::char_type* s, std::streamsize count) final override;
+		/// @brief writes the passed data to both console buffers, without swapping them.
+		/// this should be used sparingly, as it writes the data twice.
+		void write(const char* data, size_t size);
 
-		/// @brief put single char into the buffer
-		/// @return state of the overflow operation
-		std::streambuf::int_type overflow(std::streambuf::int_type ch) final override;
-
-		/// @brief flushes the buffer into stdout.
-		int sync() final override;
-
-		/// @brief swaps the console buffers, and makes sure the previously displayed buffer, is up to date with the writable buffer.
-		/// @note this also syncs the buffer.
-		void swapCBuffer();
+		/// @brief writes the passed frame to the writable buffer and swaps the console buffers,
+		/// the previously displayed buffer is then brought up to date with the frame.
+		void swapCBuffer(const char* data, size_t size);
 
 		/// @brief resizes the terminal buffers (in turn resizing the entire terminal)
 		/// the actual resizing is performed on the next swapCBuffer() call.
@@ -58,8 +48,6 @@ namespace TRInterface
 		std::array<HANDLE, 2> getCBuffers() const { return { m_hconsole_display, m_hconsole_writable }; }
 	
 	protected:
-		std::string m_buffer;
-
 		// handle to the currently displayed console buffer
 		HANDLE m_hconsole_display;
 		// handle to the currently writable console buffer
@@ -107,11 +95,7 @@ namespace TRInterface
 		bool isFocused() const;
 
 		/// @see TerminalRendererInterface::flushBuffer()
-		void flushBuffer();
-
-		/// @see TerminalRendererInterface::getBuffer()
-		/// @return 
-		std::streambuf* getBuffer() { return &m_buffer; }
+		void flushBuffer(const char* data, size_t size);
 
 	protected:
 
@@ -121,7 +121,7 @@ namespace Asciir
 	// determine the RGB values of 4 bit colour system. The colours are platform dependent
 	Colour RGB4::getColour()
 	{
-		switch (BIT_SHL(0, red) | BIT_SHL(1, green) | BIT_SHL(2, blue) | BIT_SHL(intensity, 3))
+		switch (BIT_SHL(0, red) | BIT_SHL(1, green) | BIT_SHL(2, blue) | BIT_SHL(3, intensity))
 		{
 		case IS_BLACK:
 			return BLACK8;
@@ -144,6 +144,9 @@ namespace Asciir
 		case IS_CYAN:
 			return CYAN8;
 			break;
+		case IS_WHITE:
+			return WHITE8;
+			break;
 		case IS_IBLACK:
 			return IBLACK8;
 			break;
@@ -165,6 +168,9 @@ namespace Asciir
 		case IS_ICYAN:
 			return ICYAN8;
 			break;
+		case IS_IWHITE:
+			return IWHITE8;
+			break;
 		default:
 			AR_ASSERT_MSG(false, "Invalid Colour");
 			return {};
@@ -176,6 +182,151 @@ namespace Asciir
 		return getColour();
 	}
 
+	// squared distance between two colours, ignoring the alpha channel
+	static int colourDist(const Colour& a, const Colour& b)
+	{
+		int red = (int)a.red - (int)b.red;
+		int green = (int)a.green - (int)b.green;
+		int blue = (int)a.blue - (int)b.blue;
+
+		return red * red + green * green + blue * blue;
+	}
+
+	ColourLUT::Tables::Tables()
+	{
+		// palette colours, paired with their index
+		std::vector<std::pair<Colour, uint8_t>> palette256;
+		std::vector<std::pair<Colour, uint8_t>> palette16;
+
+		palette256.reserve(240);
+		palette16.reserve(16);
+
+		for (unsigned char r = 0; r < 6; r++)
+			for (unsigned char g = 0; g < 6; g++)
+				for (unsigned char b = 0; b < 6; b++)
+				{
+					RGB8 colour(r, g, b);
+					palette256.emplace_back(colour.getColour(), (uint8_t)(16 + colour.getIndx()));
+				}
+
+		for (unsigned char grey = 0; grey < 24; grey++)
+		{
+			// the GRAY8 colour constant hides the GRAY8 structure, so it has to be explicitly named
+			struct GRAY8 colour(grey);
+			palette256.emplace_back(colour.getColour(), (uint8_t)(232 + grey));
+		}
+
+		for (uint8_t i = 0; i < 16; i++)
+			palette16.emplace_back(RGB4(i & 1, i & 2, i & 4, i & 8).getColour(), i);
+
+		for (const auto& [palette_colour, palette_index] : palette256)
+			this->palette256[palette_index] = palette_colour;
+
+		for (const auto& [palette_colour, palette_index] : palette16)
+			this->palette16[palette_index] = palette_colour;
+
+		// find the closest palette colour for the center of each lookup table cell
+		constexpr size_t cell_size = 1ULL << (8 - LUT_BITS);
+
+		auto closest = [](const Colour& colour, const std::vector<std::pair<Colour, uint8_t>>& palette)
+		{
+			int min_dist = INT_MAX;
+			uint8_t index = 0;
+
+			for (const auto& [palette_colour, palette_index] : palette)
+			{
+				int dist = colourDist(colour, palette_colour);
+
+				if (dist < min_dist)
+				{
+					min_dist = dist;
+					index = palette_index;
+				}
+			}
+
+			return index;
+		};
+
+		for (size_t r = 0; r < LUT_DIM; r++)
+			for (size_t g = 0; g < LUT_DIM; g++)
+				for (size_t b = 0; b < LUT_DIM; b++)
+				{
+					Colour colour(
+						(unsigned char)(r * cell_size + cell_size / 2),
+						(unsigned char)(g * cell_size + cell_size / 2),
+						(unsigned char)(b * cell_size + cell_size / 2));
+
+					size_t indx = (r << (LUT_BITS * 2)) | (g << LUT_BITS) | b;
+
+					colour256[indx] = closest(colour, palette256);
+					colour16[indx] = closest(colour, palette16);
+				}
+	}
+
+	const ColourLUT::Tables& ColourLUT::tables()
+	{
+		static const Tables tables;
+		return tables;
+	}
+
+	uint8_t ColourLUT::index(const Colour& colour, ColourMode mode)
+	{
+		switch (mode)
+		{
+		case ColourMode::Colour256:
+			return index256(colour);
+		case ColourMode::Colour16:
+			return index16(colour);
+		default:
+			return 0;
+		}
+	}
+
+	Colour ColourLUT::paletteColour(const Colour& colour, ColourMode mode)
+	{
+		switch (mode)
+		{
+		case ColourMode::Colour256:
+			return tables().palette256[index256(colour)];
+		case ColourMode::Colour16:
+			return tables().palette16[index16(colour)];
+		default:
+			return colour;
+		}
+	}
+
+	Colour ColourLUT::dither(const Colour& colour, TInt x, TInt y, ColourMode mode)
+	{
+		static constexpr int BAYER4[4][4] = {
+			{  0,  8,  2, 10 },
+			{ 12,  4, 14,  6 },
+			{  3, 11,  1,  9 },
+			{ 15,  7, 13,  5 }
+		};
+
+		// approximate distance between neighbouring colours in the palette
+		int spread;
+
+		switch (mode)
+		{
+		case ColourMode::Colour256:
+			spread = 40;
+			break;
+		case ColourMode::Colour16:
+			spread = 96;
+			break;
+		default:
+			return colour;
+		}
+
+		// maps the matrix value to the range [-spread / 2, spread / 2]
+		int offset = ((2 * BAYER4[y & 3][x & 3] + 1) * spread) / 32 - spread / 2;
+
+		auto channel = [offset](unsigned char value) { return (unsigned char)std::clamp((int)value + offset, 0, 255); };
+
+		return Colour(channel(colour.red), channel(colour.green), channel(colour.blue), colour.alpha);
+	}
+
 	// constructor and destructor is platform dependent
 
 	AsciiAttr::~AsciiAttr() {}
@@ -262,34 +413,193 @@ namespace Asciir
 		m_should_move = true;
 	}
 
-	void AsciiAttr::moveCode(std::string& dst)
+	void AsciiAttr::setColourMode(ColourMode mode, bool dithering)
+	{
+		m_colour_mode = mode;
+		m_dithering = dithering;
+		m_cleared = true;
+	}
+
+	Colour AsciiAttr::boldForeground() const
+	{
+		if (!attributes[BOLD])
+			return m_foreground;
+
+		auto brighten = [](unsigned char value) { return (unsigned char)std::min((int)value + AR_BOLD_DIFF, 255); };
+
+		return Colour(brighten(m_foreground.red), brighten(m_foreground.green), brighten(m_foreground.blue), m_foreground.alpha);
+	}
+
+	bool AsciiAttr::colourChanged() const
+	{
+		if (m_colour_mode == ColourMode::TrueColour)
+			return m_foreground != m_last_foreground || m_background != m_last_background;
+
+		return ColourLUT::index(m_foreground, m_colour_mode) != ColourLUT::index(m_last_foreground, m_colour_mode)
+			|| ColourLUT::index(m_background, m_colour_mode) != ColourLUT::index(m_last_background, m_colour_mode);
+	}
+
+	// decimal representation of a value in the range 0-255
+	struct DecimalString
+	{
+		char str[3];
+		uint8_t len;
+	};
+
+	static constexpr std::array<DecimalString, 256> makeDecimalTable()
+	{
+		std::array<DecimalString, 256> table = {};
+
+		for (size_t i = 0; i < table.size(); i++)
+		{
+			if (i >= 100)
+			{
+				table[i].str[0] = (char)('0' + i / 100);
+				table[i].str[1] = (char)('0' + i / 10 % 10);
+				table[i].str[2] = (char)('0' + i % 10);
+				table[i].len = 3;
+			}
+			else if (i >= 10)
+			{
+				table[i].str[0] = (char)('0' + i / 10);
+				table[i].str[1] = (char)('0' + i % 10);
+				table[i].len = 2;
+			}
+			else
+			{
+				table[i].str[0] = (char)('0' + i);
+				table[i].len = 1;
+			}
+		}
+
+		return table;
+	}
+
+	// lookup table for the colour channels and palette indexes, avoids any formatting when generating the colour codes.
+	static constexpr std::array<DecimalString, 256> DECIMAL_TABLE = makeDecimalTable();
+
+	// writes the decimal representation of the value to out
+	// all 3 bytes are always copied, so out should have space for at least 3 bytes.
+	static inline char* writeDecimal(char* out, uint8_t value)
+	{
+		const DecimalString& decimal = DECIMAL_TABLE[value];
+		memcpy(out, decimal.str, 3);
+		return out + decimal.len;
+	}
+
+	// writes the string literal to out, without the null terminator
+	template<size_t N>
+	static inline char* writeLiteral(char* out, const char(&str)[N])
+	{
+		memcpy(out, str, N - 1);
+		return out + N - 1;
+	}
+
+	char* AsciiAttr::moveCode(char* out)
 	{
 		if (m_should_move)
 		{
-			dst += AR_ANSI_CSI;
-			dst += std::to_string(m_pos.y + 1) + ';' + std::to_string(m_pos.x + 1) + 'H';
+			out = writeLiteral(out, "\x1b[");
+			out = std::to_chars(out, out + 5, m_pos.y + 1).ptr;
+			*out++ = ';';
+			out = std::to_chars(out, out + 5, m_pos.x + 1).ptr;
+			*out++ = 'H';
 
 			m_should_move = false;
 		}
+
+		return out;
+	}
+
+	void AsciiAttr::moveCode(std::string& dst)
+	{
+		char buffer[MOVE_MAX_SIZE];
+		dst.append(buffer, moveCode(buffer));
 	}
 
 
 	void AsciiAttr::moveCode(std::ostream& stream)
 	{
-		if (m_should_move)
+		char buffer[MOVE_MAX_SIZE];
+		stream.write(buffer, moveCode(buffer) - buffer);
+	}
+
+	char* AsciiAttr::colourCode(char* out)
+	{
+		Colour foreground = boldForeground();
+
+		// the palette modes are keyed on the quantised indices, so colours that map to the same palette colours share an entry
+		uint8_t foreground_indx = 0;
+		uint8_t background_indx = 0;
+		uint64_t key;
+
+		if (m_colour_mode == ColourMode::TrueColour)
+		{
+			key = SGRCache::key(foreground, m_background, m_colour_mode);
+		}
+		else
 		{
-			stream << AR_ANSI_CSI;
-			stream << std::to_string(m_pos.y + 1) << ';' << std::to_string(m_pos.x + 1) << 'H';
+			foreground_indx = ColourLUT::index(foreground, m_colour_mode);
+			background_indx = ColourLUT::index(m_background, m_colour_mode);
+			key = SGRCache::key(foreground_indx, background_indx, m_colour_mode);
+		}
 
-			m_should_move = false;
+		SGRCache::Entry& entry = m_sgr_cache.slot(key);
+
+		// the entire code buffer is copied, so the copy has a fixed size. out always has space for this many bytes.
+		if (entry.key == key)
+		{
+			memcpy(out, entry.code, SGRCache::CODE_MAX_SIZE);
+			return out + entry.length;
 		}
+
+		// the code is encoded directly into out, and then copied into the cache.
+		// only the encoded bytes are copied, the rest of out has not been written, and the rest of the entry is cleared.
+		char* end = encodeColourCode(out, foreground, foreground_indx, background_indx);
+
+		entry.key = key;
+		entry.length = (uint8_t)(end - out);
+		memcpy(entry.code, out, entry.length);
+		memset(entry.code + entry.length, 0, SGRCache::CODE_MAX_SIZE - entry.length);
+
+		return end;
 	}
 
-	// helper function for converting an integer to a string, with known maximum integer length, in order to avoid heap allocation
-	template<size_t w, typename T>
-	void fixedToString(T value, char* out)
+	char* AsciiAttr::encodeColourCode(char* out, const Colour& foreground, uint8_t foreground_indx, uint8_t background_indx) const
 	{
-		snprintf(out, w + 1, "%d", value);
+		switch (m_colour_mode)
+		{
+		case ColourMode::Colour256:
+			out = writeLiteral(out, ";38;5;");
+			out = writeDecimal(out, foreground_indx);
+			out = writeLiteral(out, ";48;5;");
+			out = writeDecimal(out, background_indx);
+			break;
+		case ColourMode::Colour16:
+			// 30-37 / 40-47 for the standard colours, 90-97 / 100-107 for the intense colours
+			*out++ = ';';
+			out = writeDecimal(out, (uint8_t)((foreground_indx & 8 ? 90 : 30) + (foreground_indx & 7)));
+			*out++ = ';';
+			out = writeDecimal(out, (uint8_t)((background_indx & 8 ? 100 : 40) + (background_indx & 7)));
+			break;
+		default:
+			out = writeLiteral(out, ";38;2;");
+			out = writeDecimal(out, foreground.red);
+			*out++ = ';';
+			out = writeDecimal(out, foreground.green);
+			*out++ = ';';
+			out = writeDecimal(out, foreground.blue);
+
+			out = writeLiteral(out, ";48;2;");
+			out = writeDecimal(out, m_background.red);
+			*out++ = ';';
+			out = writeDecimal(out, m_background.green);
+			*out++ = ';';
+			out = writeDecimal(out, m_background.blue);
+			break;
+		}
+
+		return out;
 	}
 
 	std::string AsciiAttr::ansiCode()
@@ -347,52 +657,20 @@ namespace Asciir
 		if (attributes[STRIKE])
 			dst += ";9";
 
-		// colour string buffer
-		char colour_buffer[4];
-
-		// foreground colour
-
-		unsigned char red = m_foreground.red;
-		unsigned char green = m_foreground.green;
-		unsigned char blue = m_foreground.blue;
-
-		if (attributes[BOLD])
-		{
-			red += AR_BOLD_DIFF;
-			green += AR_BOLD_DIFF;
-			blue += AR_BOLD_DIFF;
-
-			red = red > m_foreground.red ? red : 255;
-			green = green > m_foreground.green ? green : 255;
-			blue = blue > m_foreground.blue ? blue : 255;
-		}
+		// colour
+		char colour_buffer[ATTR_MAX_SIZE];
+		dst.append(colour_buffer, colourCode(colour_buffer));
 
-		dst += ";38;2;";
-		fixedToString<3>(red, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
-		fixedToString<3>(green, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
-		fixedToString<3>(blue, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
-		
-
-		// background colour
-		dst += "48;2;";
-		fixedToString<3>(m_background.red, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
-		fixedToString<3>(m_background.green, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
-		fixedToString<3>(m_background.blue, colour_buffer);
-		dst += colour_buffer;
-		dst += ";";
+		dst += 'm';
 	}
 
 	void AsciiAttr::ansiCode(std::ostream& stream, bool is_newline)
+	{
+		char buffer[MOVE_MAX_SIZE + ATTR_MAX_SIZE];
+		stream.write(buffer, ansiCode(buffer, is_newline) - buffer);
+	}
+
+	char* AsciiAttr::ansiCode(char* out, bool is_newline)
 	{
 	#if 0
 		SetConsoleTextAttribute(m_hConsole, DEFAULT_FOREGROUND
@@ -402,7 +680,7 @@ namespace Asciir
 	#endif
 
 		// cursor
-		moveCode(stream);
+		out = moveCode(out);
 
 		// if nothing has changed do not modify the stream
 		if (!m_cleared)
@@ -415,87 +693,88 @@ namespace Asciir
 					break;
 				}
 
-			if (!has_changed && m_foreground != m_last_foreground)
-				has_changed = true;
-
-			if (!has_changed && m_background != m_last_background)
-				has_changed = true;
-
-			if (m_cleared)
+			if (!has_changed && colourChanged())
 				has_changed = true;
 
 			if (!has_changed)
-				return;
+				return out;
 		}
 
-		// colour string buffer
-		char colour_buffer[4];
-
 		// formatting
-		stream << AR_ANSI_CSI;
+
+		// every parameter is written with a leading ';', the first of these is replaced with the '[' of the CSI afterwards.
+		// an empty first parameter would otherwise be interpreted as a reset, clearing the colours if they are not part of the code.
+		*out++ = '\x1b';
+		char* params = out;
 
 		// TODO: no reason for clear of attributes when m_cleared is set
 
 		if (attributes[ITALIC] && (!last_attributes[ITALIC] || m_cleared))
-			stream << ";3";
+			out = writeLiteral(out, ";3");
 		else if (!attributes[ITALIC] && (last_attributes[ITALIC] || m_cleared))
-			stream << ";23";
+			out = writeLiteral(out, ";23");
 
 		if (attributes[UNDERLINE] && (!last_attributes[UNDERLINE] || m_cleared))
-			stream << ";4";
+			out = writeLiteral(out, ";4");
 		else if (!attributes[UNDERLINE] && (last_attributes[UNDERLINE] || m_cleared))
-			stream << ";24";
+			out = writeLiteral(out, ";24");
 
 		if (attributes[BLINK] && (!last_attributes[BLINK] || m_cleared))
-			stream << ";5";
+			out = writeLiteral(out, ";5");
 		else if (!attributes[BLINK] && (last_attributes[BLINK] || m_cleared))
-			stream << ";25";
+			out = writeLiteral(out, ";25");
 
 		if (attributes[STRIKE] && (!last_attributes[STRIKE] || m_cleared))
-			stream << ";9";
+			out = writeLiteral(out, ";9");
 		else if (!attributes[STRIKE] && (last_attributes[STRIKE] || m_cleared))
-			stream << ";29";
+			out = writeLiteral(out, ";29");
 
 		// colour
-		if (attributes[BOLD] != last_attributes[BOLD] || m_background != m_last_background || m_foreground != m_last_foreground || m_cleared || is_newline)
+		if (attributes[BOLD] != last_attributes[BOLD] || colourChanged() || m_cleared || is_newline)
+			out = colourCode(out);
+
+		// only attributes without an ansi code have changed, so nothing should be written
+		if (out == params)
 		{
+			silentStore();
+			return params - 1;
+		}
 
-			unsigned char red = m_foreground.red;
-			unsigned char green = m_foreground.green;
-			unsigned char blue = m_foreground.blue;
+		*params = '[';
+		*out++ = 'm';
 
-			if (attributes[BOLD])
-			{
-				red += AR_BOLD_DIFF;
-				green += AR_BOLD_DIFF;
-				blue += AR_BOLD_DIFF;
+		silentStore();
 
-				red = red > m_foreground.red ? red : 255;
-				green = green > m_foreground.green ? green : 255;
-				blue = blue > m_foreground.blue ? blue : 255;
-			}
-			
-
-			stream << ";38;2;";
-			fixedToString<3>(red, colour_buffer);
-			stream << colour_buffer << ';';
-			fixedToString<3>(green, colour_buffer);
-			stream << colour_buffer << ';';
-			fixedToString<3>(blue, colour_buffer);
-			stream << colour_buffer;
-
-			stream << ";48;2;";
-			fixedToString<3>(m_background.red, colour_buffer);
-			stream << colour_buffer << ';';
-			fixedToString<3>(m_background.green, colour_buffer);
-			stream << colour_buffer << ';';
-			fixedToString<3>(m_background.blue, colour_buffer);
-			stream << colour_buffer;
+		return out;
+	}
+
+	char* AsciiAttr::encodeTile(char* out, const Tile& tile, TermVert pos, bool is_newline)
+	{
+		if (m_dithering)
+		{
+			m_foreground = ColourLUT::dither(tile.colour, pos.x, pos.y, m_colour_mode);
+			m_background = ColourLUT::dither(tile.background_colour, pos.x, pos.y, m_colour_mode);
+		}
+		else
+		{
+			m_foreground = tile.colour;
+			m_background = tile.background_colour;
 		}
 
-		stream << 'm';
+		out = ansiCode(out, is_newline);
 
-		silentStore();
+		// a null character would not move the cursor, so it is replaced by a space
+		size_t length = tile.symbol.length();
+
+		if (length == 0)
+		{
+			*out++ = ' ';
+			return out;
+		}
+
+		memcpy(out, tile.symbol.data(), length);
+
+		return out + length;
 	}
 
 	void AsciiAttr::silentStore()
@@ -512,6 +791,14 @@ namespace Asciir
 		stream << AR_ANSI_OSC << "0;" << name << '\a';
 	}
 
+	void AsciiAttr::setTitle(std::string& dst, const std::string& name)
+	{
+		dst += AR_ANSI_OSC;
+		dst += "0;";
+		dst += name;
+		dst += '\a';
+	}
+
 	std::ostream& operator<<(std::ostream& stream, const Colour& c)
 	{
 		stream << std::setfill(' ') << std::setw(3) << (int)c.red << ' '
@@ -63,6 +63,15 @@ namespace Asciir
 	// 1 byte for the ending m
 	static constexpr size_t ATTR_MAX_SIZE = 2 + (5 + 4 * 3) * 2 + ATTR_COUNT * 3 + 1;
 
+	/// @brief the maximum length, in bytes, of an absolute cursor move sequence.
+	// 2 bytes for the escape sequence start
+	// 5 bytes for each coordinate, as TInt has at most 5 digits
+	// 1 byte for the seperator, and 1 for the ending H
+	static constexpr size_t MOVE_MAX_SIZE = 2 + 5 + 1 + 5 + 1;
+
+	/// @brief the maximum length, in bytes, of a single encoded tile (cursor move, ansi code and UTF-8 character).
+	static constexpr size_t TILE_CODE_MAX_SIZE = MOVE_MAX_SIZE + ATTR_MAX_SIZE + 4;
+
 	/// @brief structure representing a 32 bit rgba colour value.
 	struct Colour
 	{
@@ -75,6 +84,7 @@ namespace Asciir
 		/// @brief constructs a grey scale colour value from the given grey value.
 		Colour(unsigned char grey, unsigned char a = UCHAR_MAX);
 		Colour(const Colour& other);
+		Colour& operator=(const Colour& other) = default;
 
 		/// @brief returns the inverse of the colour
 		Colour inverse() const;
@@ -155,7 +165,151 @@ namespace Asciir
 		operator Colour();
 	};
 
+
+	/// @brief the colour depth used for the colour codes generated by AsciiAttr.
+	enum class ColourMode
+	{
+		/// @brief 24 bit colours (38;2;r;g;b)
+		TrueColour,
+		/// @brief the xterm 256 colour palette (38;5;n), only the colour cube and the grey scale colours are used, as the first 16 colours are terminal dependent.
+		Colour256,
+		/// @brief the 16 standard and intense ansi colours (3x / 9x)
+		Colour16
+	};
+
+	/// @brief maps Colour values to terminal palette indexes, using precomputed lookup tables.
+	///
+	/// each lookup table is a 3D table, with 5 bits per channel, containing the index of the closest palette colour.
+	/// the tables are computed on first use.
+	class ColourLUT
+	{
+	public:
+		/// @brief returns the index of the closest colour in the xterm 256 colour palette (16-255).
+		static uint8_t index256(const Colour& colour) { return tables().colour256[lutIndex(colour)]; }
+		/// @brief returns the index of the closest colour in the 16 colour palette (0-15).
+		/// bit 0, 1 and 2 are red, green and blue, bit 3 is the intensity, same as the ansi colour codes.
+		static uint8_t index16(const Colour& colour) { return tables().colour16[lutIndex(colour)]; }
+
+		/// @brief returns the palette index of the colour for the given colour mode.
+		/// for ColourMode::TrueColour, 0 is returned.
+		static uint8_t index(const Colour& colour, ColourMode mode);
+
+		/// @brief returns the palette colour the passed colour is mapped to in the given colour mode.
+		/// for ColourMode::TrueColour, the colour is returned unmodified.
+		static Colour paletteColour(const Colour& colour, ColourMode mode);
+
+		/// @brief offsets the passed colour using a 4x4 ordered (bayer) dithering matrix, based on the passed position.
+		/// the offset is scaled by the distance between the colours in the palette for the passed colour mode.
+		/// for ColourMode::TrueColour, the colour is returned unmodified.
+		static Colour dither(const Colour& colour, TInt x, TInt y, ColourMode mode);
+
+	protected:
+		static constexpr size_t LUT_BITS = 5;
+		static constexpr size_t LUT_DIM = 1ULL << LUT_BITS;
+		static constexpr size_t LUT_SIZE = LUT_DIM * LUT_DIM * LUT_DIM;
+
+		struct Tables
+		{
+			std::array<uint8_t, LUT_SIZE> colour256;
+			std::array<uint8_t, LUT_SIZE> colour16;
+
+			// colour values of the palette indexes
+			std::array<Colour, 256> palette256;
+			std::array<Colour, 16> palette16;
+
+			Tables();
+		};
+
+		static const Tables& tables();
+
+		static size_t lutIndex(const Colour& colour)
+		{
+			constexpr size_t shift = 8 - LUT_BITS;
+			return ((size_t)(colour.red >> shift) << (LUT_BITS * 2)) | ((size_t)(colour.green >> shift) << LUT_BITS) | (size_t)(colour.blue >> shift);
+		}
+	};
 	
+	struct Tile;
+
+	/// @brief bounded cache of encoded colour codes, used by AsciiAttr to avoid formatting the same colour code repeatedly.
+	/// 
+	/// the cache maps the foreground, background and colour mode of a colour code to the encoded bytes (";38;...;48;...").
+	/// in the palette modes, the colours are keyed on their palette indices, so all colours that quantise to the same indices share an entry.
+	/// it is direct mapped, so a lookup is a single hash and compare, and a miss simply replaces the entry in its slot.
+	/// 
+	/// the entries are allocated on the first lookup, and are kept between frames, until clear() is called.
+	/// the entries are not part of the attribute state, so they are not copied when the owning AsciiAttr is copied.
+	/// 
+	class SGRCache
+	{
+	public:
+		/// @brief the number of entries in the cache, must be a power of 2.
+		static constexpr size_t CAPACITY = 1024;
+		/// @brief the maximum length of an encoded colour code, ";38;2;rrr;ggg;bbb" for both colours.
+		static constexpr size_t CODE_MAX_SIZE = (6 + 3 * 3 + 2) * 2;
+
+		struct Entry
+		{
+			uint64_t key = 0;
+			uint8_t length = 0;
+			/// @brief the bytes after length are always 0, so the entire buffer can be copied on a hit.
+			char code[CODE_MAX_SIZE] = {};
+		};
+
+		SGRCache() = default;
+		SGRCache(const SGRCache&) {}
+		SGRCache& operator=(const SGRCache&) { return *this; }
+
+		/// @brief returns the key of the passed colours and colour mode.
+		static uint64_t key(const Colour& foreground, const Colour& background, ColourMode mode)
+		{
+			// the highest bit marks the entry as used, so no valid key is 0
+			return (1ULL << 63) | ((uint64_t)mode << 48)
+				| ((uint64_t)foreground.red << 40) | ((uint64_t)foreground.green << 32) | ((uint64_t)foreground.blue << 24)
+				| ((uint64_t)background.red << 16) | ((uint64_t)background.green << 8) | (uint64_t)background.blue;
+		}
+
+		/// @brief returns the key of the passed palette indices and colour mode, used for the Colour256 and Colour16 modes.
+		static uint64_t key(uint8_t foreground_indx, uint8_t background_indx, ColourMode mode)
+		{
+			// the mode differs from the TrueColour mode, so an index key never collides with a rgb key
+			return (1ULL << 63) | ((uint64_t)mode << 48) | ((uint64_t)foreground_indx << 8) | (uint64_t)background_indx;
+		}
+
+		/// @brief returns the entry the passed key is stored in.
+		/// if the key of the entry differs from the passed key, the colour code is not cached, and the entry should be overwritten.
+		Entry& slot(uint64_t key)
+		{
+			if (m_entries.empty())
+				m_entries.resize(CAPACITY);
+
+			Entry& entry = m_entries[(key * 0x9E3779B97F4A7C15ULL) >> (64 - CAPACITY_BITS)];
+
+			if (entry.key == key)
+				m_hits++;
+			else
+				m_misses++;
+
+			return entry;
+		}
+
+		/// @brief removes all entries from the cache.
+		void clear() { m_entries.clear(); }
+
+		/// @brief the number of lookups that found their colour code in the cache, since the cache was constructed.
+		size_t hits() const { return m_hits; }
+		/// @brief the number of lookups that had to encode their colour code, since the cache was constructed.
+		size_t misses() const { return m_misses; }
+
+	protected:
+		static constexpr size_t CAPACITY_BITS = 10;
+		static_assert(1ULL << CAPACITY_BITS == CAPACITY, "CAPACITY_BITS does not match CAPACITY");
+
+		std::vector<Entry> m_entries;
+		size_t m_hits = 0;
+		size_t m_misses = 0;
+	};
+
 	/// @brief class for storing and modifying the ansi attributes of an ascii character
 	/// 
 	/// also generates the corresponding ansi code that should be printed to the terminal in order to apply the attributes
@@ -188,6 +342,25 @@ namespace Asciir
 		bool m_should_move = false;
 		bool m_cleared = true;
 
+		ColourMode m_colour_mode = ColourMode::TrueColour;
+		bool m_dithering = false;
+
+		SGRCache m_sgr_cache;
+
+		/// @brief returns the foreground colour, with the bold attribute applied.
+		Colour boldForeground() const;
+		/// @brief checks if the colours have changed since the last ansi code, taking the colour mode into account.
+		/// two different colours might end up as the same palette colour, in which case they are not considered changed.
+		bool colourChanged() const;
+		/// @brief writes the colour part of the ansi code (";38;...;48;...") to out, using the current colour mode.
+		/// the code is copied from the SGRCache, if the same colours have been encoded recently.
+		/// out must have space for at least SGRCache::CODE_MAX_SIZE bytes.
+		/// @return pointer to the byte after the last written byte.
+		char* colourCode(char* out);
+		/// @brief same as colourCode(), but always formats the code.
+		/// the passed indices are the palette indices of the colours, and are ignored in the TrueColour mode.
+		char* encodeColourCode(char* out, const Colour& foreground, uint8_t foreground_indx, uint8_t background_indx) const;
+
 	public:
 		/// @brief list of the attributes to be set / cleared on the next ansiCode() call.
 		std::array<bool, ATTR_COUNT> attributes = { false };
@@ -216,6 +389,16 @@ namespace Asciir
 		/// @brief moves the terminal cursor to the specified column and row in the terminal.
 		void move(TermVert pos);
 
+		/// @brief sets the colour depth of the generated colour codes.
+		/// @param dithering if true, the renderer should dither the colours using ColourLUT::dither() before passing them to the AsciiAttr.
+		void setColourMode(ColourMode mode, bool dithering = false);
+		ColourMode getColourMode() const { return m_colour_mode; }
+		/// @brief returns wether the colours should be dithered, before being passed to the AsciiAttr.
+		bool getDithering() const { return m_dithering; }
+
+		/// @brief returns the cache of encoded colour codes, @see SGRCache.
+		const SGRCache& getSGRCache() const { return m_sgr_cache; }
+
 #ifdef AR_WIN
 
 		void setBoxed(bool val);
@@ -238,6 +421,21 @@ namespace Asciir
 		///
 		/// @param is_newline should be set to true if the stream has recieved a newline since the last call to ansiCode(std::ostream&, bool).
 		void ansiCode(std::ostream& stream, bool is_newline = false);
+		/// @brief same as ansiCode(std::ostream&, bool), but writes the ansi code directly into the passed buffer.
+		/// the buffer must have space for at least MOVE_MAX_SIZE + ATTR_MAX_SIZE bytes.
+		/// @return pointer to the byte after the last written byte.
+		char* ansiCode(char* out, bool is_newline = false);
+
+		/// @brief encodes an entire tile into the passed buffer.
+		/// 
+		/// this sets the colours to the tile colours (dithered at pos, if dithering is enabled),
+		/// and writes the move code, the ansi code and the UTF-8 character of the tile.
+		/// a null character is written as a space, so the cursor always moves a single tile.
+		/// 
+		/// the buffer must have space for at least TILE_CODE_MAX_SIZE bytes.
+		/// 
+		/// @return pointer to the byte after the last written byte.
+		char* encodeTile(char* out, const Tile& tile, TermVert pos, bool is_newline = false);
 
 		/// @brief acts as if ansiCode has been called, without actually generating an ansi escape sequence.  
 		/// this simply stores the current state of the attributes, as the last state.
@@ -249,10 +447,16 @@ namespace Asciir
 		/// @brief same as moveCode(std::string&)
 		/// @brief the ostream that will recieve the move code
 		void moveCode(std::ostream& stream);
+		/// @brief same as moveCode(std::string&), but writes the move code directly into the passed buffer.
+		/// the buffer must have space for at least MOVE_MAX_SIZE bytes.
+		/// @return pointer to the byte after the last written byte.
+		char* moveCode(char* out);
 
 
 		/// @brief genereates the ansi coe that will change the name of the active console to the passed name, and puts it in to the specified stream.
 		void setTitle(std::ostream& stream, const std::string& name);
+		/// @brief same as setTitle(std::ostream&, const std::string&), but appends the ansi code to dst.
+		void setTitle(std::string& dst, const std::string& name);
 	};
 
 	/// @brief same as other.ansiCode(stream)
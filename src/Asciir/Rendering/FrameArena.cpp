@@ -0,0 +1,52 @@
+#include "arpch.h"
+#include "FrameArena.h"
+
+namespace Asciir
+{
+	FrameArena::FrameArena(size_t initial_capacity)
+		: m_min_capacity(initial_capacity)
+	{
+		reallocate(initial_capacity);
+	}
+
+	void FrameArena::clear()
+	{
+		m_high_water = std::max(m_high_water, m_size);
+		m_window_frames++;
+
+		if (m_window_frames >= SHRINK_WINDOW)
+		{
+			// only shrink if more than half of the arena has gone unused for the entire window,
+			// the new capacity leaves some room for the frame size to increase again.
+			size_t target_capacity = std::max(m_min_capacity, m_high_water + m_high_water / 4);
+
+			if (target_capacity < m_capacity / 2)
+			{
+				m_size = 0;
+				reallocate(target_capacity);
+			}
+
+			m_high_water = 0;
+			m_window_frames = 0;
+		}
+
+		m_size = 0;
+	}
+
+	void FrameArena::grow(size_t count)
+	{
+		// grow geometrically, so a slowly growing frame size does not result in a reallocation each frame
+		reallocate(std::max(m_size + count, m_capacity * 2));
+	}
+
+	void FrameArena::reallocate(size_t new_capacity)
+	{
+		std::unique_ptr<char[]> new_data(new_capacity > 0 ? new char[new_capacity] : nullptr);
+
+		if (m_size > 0)
+			memcpy(new_data.get(), m_data.get(), m_size);
+
+		m_data = std::move(new_data);
+		m_capacity = new_capacity;
+	}
+}
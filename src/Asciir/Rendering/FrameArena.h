@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Asciir/Core/Core.h"
+
+namespace Asciir
+{
+	/// @brief contiguous byte buffer receiving the encoded ansi data of a single frame.
+	/// 
+	/// the encoder writes directly into the arena memory, by reserving the maximum number of bytes it might write,
+	/// and then committing the bytes that were actually written.
+	/// 
+	/// the arena grows when a frame does not fit inside it, and shrinks to the high-water mark of recent frames,
+	/// if the recent frames have needed much less memory than currently allocated.
+	/// this way no memory has to be reserved for a worst case frame up front, and no allocations happen when the frame sizes are stable.
+	/// 
+	class FrameArena
+	{
+	public:
+		/// @brief constructs an arena with the given initial capacity.
+		/// the arena will never shrink below this capacity.
+		FrameArena(size_t initial_capacity = 0);
+
+		FrameArena(FrameArena&& other) noexcept = default;
+		FrameArena& operator=(FrameArena&& other) noexcept = default;
+
+		/// @brief returns a pointer, where at least count bytes can be written to.
+		/// commit() must be called with the end of the written data afterwards.
+		/// @note any pointers previously retrieved from the arena are invalidated.
+		char* reserve(size_t count)
+		{
+			if (m_capacity - m_size < count)
+				grow(count);
+
+			return m_data.get() + m_size;
+		}
+
+		/// @brief marks all bytes up until end as written.
+		/// end must be a pointer into the memory returned by the latest reserve() call.
+		void commit(const char* end)
+		{
+			m_size = end - m_data.get();
+		}
+
+		/// @brief appends the passed data to the arena.
+		void write(const char* data, size_t size)
+		{
+			// data may be null for an empty write, which memcpy does not allow.
+			if (size == 0)
+				return;
+
+			memcpy(reserve(size), data, size);
+			m_size += size;
+		}
+
+		/// @brief appends a single byte to the arena.
+		void put(char c)
+		{
+			*reserve(1) = c;
+			m_size++;
+		}
+
+		/// @brief returns a pointer to the start of the current frame data.
+		const char* data() const { return m_data.get(); }
+		/// @brief returns the size of the current frame data in bytes.
+		size_t size() const { return m_size; }
+		/// @brief returns the currently allocated size of the arena in bytes.
+		size_t capacity() const { return m_capacity; }
+		/// @brief returns wether no data has been written to the arena since the last call to clear().
+		bool empty() const { return m_size == 0; }
+
+		/// @brief ends the current frame, and resets the arena for the next frame.
+		/// 
+		/// the size of the ended frame is used for the high-water mark,
+		/// and the arena memory is shrunk, if it has been much larger than needed for the past frames.
+		void clear();
+
+	protected:
+		/// @brief grows the arena, so it has space for at least count more bytes.
+		void grow(size_t count);
+		/// @brief reallocates the arena memory to the passed capacity, the current frame data is preserved.
+		void reallocate(size_t new_capacity);
+
+		// number of frames the high-water mark is calculated over
+		static constexpr size_t SHRINK_WINDOW = 256;
+
+		std::unique_ptr<char[]> m_data;
+		size_t m_size = 0;
+		size_t m_capacity = 0;
+		size_t m_min_capacity = 0;
+
+		// largest frame size in the current window
+		size_t m_high_water = 0;
+		size_t m_window_frames = 0;
+	};
+}
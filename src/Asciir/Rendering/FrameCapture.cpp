@@ -0,0 +1,110 @@
+#include "arpch.h"
+#include "FrameCapture.h"
+
+namespace Asciir
+{
+	static constexpr char CAPTURE_MAGIC[4] = { 'A', 'R', 'C', 'P' };
+
+	// the values are stored byte by byte, so the file is the same on every platform.
+	template<typename T>
+	static void writeValue(std::ofstream& file, T value)
+	{
+		char bytes[sizeof(T)];
+
+		for (size_t i = 0; i < sizeof(T); i++)
+			bytes[i] = (char)(((uint64_t)value >> (i * 8)) & 0xFF);
+
+		file.write(bytes, sizeof(T));
+	}
+
+	template<typename T>
+	static bool readValue(std::ifstream& file, T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+
+		if (!file.read((char*)bytes, sizeof(T)))
+			return false;
+
+		uint64_t result = 0;
+
+		for (size_t i = 0; i < sizeof(T); i++)
+			result |= (uint64_t)bytes[i] << (i * 8);
+
+		value = (T)result;
+
+		return true;
+	}
+
+	// ============ CaptureWriter ============
+
+	CaptureWriter::CaptureWriter(const std::filesystem::path& path)
+		: m_file(path, std::ios::binary | std::ios::trunc)
+	{
+		if (!m_file.is_open())
+			return;
+
+		m_file.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+		writeValue(m_file, VERSION);
+	}
+
+	void CaptureWriter::write(DeltaTime time, TInt width, TInt height, const char* data, size_t size)
+	{
+		if (m_frame_count == 0)
+			m_start = time;
+
+		writeValue(m_file, (uint64_t)(time - m_start).nanoSeconds());
+		writeValue(m_file, (uint32_t)size);
+		writeValue(m_file, (int16_t)width);
+		writeValue(m_file, (int16_t)height);
+		m_file.write(data, size);
+
+		m_frame_count++;
+	}
+
+	// ============ CaptureReader ============
+
+	CaptureReader::CaptureReader(const std::filesystem::path& path)
+		: m_file(path, std::ios::binary)
+	{
+		char magic[sizeof(CAPTURE_MAGIC)];
+		uint32_t version;
+
+		if (!m_file.read(magic, sizeof(magic)) || memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0)
+			return;
+
+		if (!readValue(m_file, version) || version != CaptureWriter::VERSION)
+			return;
+
+		m_first_frame = m_file.tellg();
+		m_valid = true;
+	}
+
+	bool CaptureReader::next(CaptureFrame& frame)
+	{
+		if (!m_valid)
+			return false;
+
+		uint64_t time;
+		uint32_t size;
+		int16_t width, height;
+
+		if (!readValue(m_file, time) || !readValue(m_file, size) || !readValue(m_file, width) || !readValue(m_file, height))
+			return false;
+
+		frame.time = DeltaTime(duration(time));
+		frame.width = width;
+		frame.height = height;
+		frame.data.resize(size);
+
+		return (bool)m_file.read(frame.data.data(), size);
+	}
+
+	void CaptureReader::rewind()
+	{
+		if (!m_valid)
+			return;
+
+		m_file.clear();
+		m_file.seekg(m_first_frame);
+	}
+}
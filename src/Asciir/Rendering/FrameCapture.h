@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Asciir/Core/Core.h"
+#include "Asciir/Core/Timing.h"
+
+namespace Asciir
+{
+	/// @brief a single frame of a capture file.
+	struct CaptureFrame
+	{
+		/// @brief the time the frame was written to the terminal, relative to the start of the capture.
+		DeltaTime time;
+		/// @brief the size of the terminal when the frame was drawn.
+		TInt width = 0;
+		TInt height = 0;
+		/// @brief the ansi data written to the terminal.
+		std::vector<char> data;
+	};
+
+	/// @brief writes the output of a TerminalRenderer to a capture file, @see TerminalRendererInterface::startCapture().
+	///
+	/// the capture file is a compact binary format, consisting of a header followed by the frames:
+	/// > header: "ARCP" | uint32 version
+	/// > frame:  uint64 time (nanoseconds since the capture started) | uint32 data size | int16 width | int16 height | data
+	///
+	/// all values are stored in little endian.
+	/// the data is the exact sequence of bytes written to the terminal, so it can be replayed without the application, @see CaptureReader.
+	///
+	class CaptureWriter
+	{
+	public:
+		static constexpr uint32_t VERSION = 1;
+
+		/// @brief opens the passed file for writing, any existing file is overwritten.
+		/// use isOpen() to check if this succeeded.
+		CaptureWriter(const std::filesystem::path& path);
+
+		/// @brief returns wether the capture file could be opened.
+		bool isOpen() const { return m_file.is_open(); }
+
+		/// @brief appends a frame to the capture file.
+		/// @param time the time the frame is written at, @see getTime(). the first frame marks the start of the capture.
+		void write(DeltaTime time, TInt width, TInt height, const char* data, size_t size);
+
+		/// @brief returns the number of frames written to the capture file.
+		size_t frameCount() const { return m_frame_count; }
+
+	protected:
+		std::ofstream m_file;
+		DeltaTime m_start;
+		size_t m_frame_count = 0;
+	};
+
+	/// @brief reads the frames of a capture file written by CaptureWriter.
+	class CaptureReader
+	{
+	public:
+		/// @brief opens the passed capture file, and reads its header.
+		/// use isOpen() to check if this succeeded.
+		CaptureReader(const std::filesystem::path& path);
+
+		/// @brief returns wether the capture file could be opened, and has a valid header.
+		bool isOpen() const { return m_valid; }
+
+		/// @brief reads the next frame into the passed frame, reusing its data buffer.
+		/// @return false if there are no more frames, or the file is truncated.
+		bool next(CaptureFrame& frame);
+
+		/// @brief moves back to the first frame of the capture.
+		void rewind();
+
+	protected:
+		std::ifstream m_file;
+		std::streampos m_first_frame;
+		bool m_valid = false;
+	};
+}
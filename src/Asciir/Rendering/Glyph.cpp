@@ -0,0 +1,106 @@
+#include "arpch.h"
+#include "Glyph.h"
+#include "TerminalRenderer.h"
+
+namespace Asciir
+{
+	// the hash table maps the UTF-8 bytes of a symbol, packed into a 32 bit integer, to its id.
+	// it has twice as many slots as there are ids, so the probe sequences stay short, even when the glyph table is full.
+	static constexpr size_t HASH_BITS = 17;
+	static constexpr size_t HASH_SLOTS = 1 << HASH_BITS;
+
+	// an empty slot has the key 0, which is never the key of a non ascii symbol.
+	static std::atomic<uint32_t> s_keys[HASH_SLOTS];
+	static std::atomic<uint16_t> s_ids[HASH_SLOTS];
+
+	static std::mutex s_insert_mutex;
+	static size_t s_count = GlyphTable::ASCII_GLYPHS;
+
+	static size_t hashSlot(uint32_t key)
+	{
+		return (size_t)((key * 2654435761U) >> (32 - HASH_BITS));
+	}
+
+	uint16_t GlyphTable::intern(const char* symbol, size_t length)
+	{
+		AR_ASSERT_MSG(length <= MAX_LENGTH, "Glyph must be at most ", MAX_LENGTH, " bytes, found ", length);
+		length = std::min(length, MAX_LENGTH);
+
+		if (length == 0)
+			return 0;
+
+		if (length == 1 && (unsigned char)symbol[0] < ASCII_GLYPHS)
+			return (uint16_t)(unsigned char)symbol[0];
+
+		uint32_t key = 0;
+		for (size_t i = 0; i < length; i++)
+			key |= (uint32_t)(unsigned char)symbol[i] << (i * 8);
+
+		size_t slot = hashSlot(key);
+
+		// lock free lookup, the key is stored after the id, so a matching key always has a valid id.
+		for (uint32_t slot_key; (slot_key = s_keys[slot].load(std::memory_order_acquire)) != 0; slot = (slot + 1) % HASH_SLOTS)
+			if (slot_key == key)
+				return s_ids[slot].load(std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(s_insert_mutex);
+
+		// another thread may have inserted the symbol, or a different symbol into the empty slot, before the lock was acquired.
+		for (uint32_t slot_key; (slot_key = s_keys[slot].load(std::memory_order_relaxed)) != 0; slot = (slot + 1) % HASH_SLOTS)
+			if (slot_key == key)
+				return s_ids[slot].load(std::memory_order_relaxed);
+
+		if (s_count == MAX_GLYPHS)
+		{
+			AR_ASSERT_MSG(false, "Glyph table is full, cannot add more than ", MAX_GLYPHS, " distinct symbols");
+			return '?';
+		}
+
+		uint16_t id = (uint16_t)s_count++;
+
+		Entry& entry = s_entries[id];
+		memcpy(entry.bytes, symbol, length);
+		entry.bytes[length] = '\0';
+		entry.length = (uint8_t)length;
+
+		s_ids[slot].store(id, std::memory_order_relaxed);
+		s_keys[slot].store(key, std::memory_order_release);
+
+		return id;
+	}
+
+	uint16_t GlyphTable::intern(const char* symbol)
+	{
+		AR_ASSERT_MSG(U8Len(symbol) < 2, "u8 string must only contain one or less characters, found ", U8Len(symbol));
+
+		if (symbol[0] == '\0')
+			return 0;
+
+		// only the first character is interned, so a longer string never ends up as a multi character glyph.
+		size_t length = U8CharSize(symbol);
+
+		// do not read past the end of a truncated character
+		for (size_t i = 1; i < length; i++)
+		{
+			if (symbol[i] == '\0')
+			{
+				length = i;
+				break;
+			}
+		}
+
+		return intern(symbol, length);
+	}
+
+	size_t GlyphTable::size()
+	{
+		std::lock_guard<std::mutex> lock(s_insert_mutex);
+		return s_count;
+	}
+
+	Glyph::Glyph(wchar_t wc)
+		: Glyph(UTF8Char(wc)) {}
+
+	Glyph::Glyph(const UTF8Char& symbol)
+		: m_id(GlyphTable::intern(symbol)) {}
+}
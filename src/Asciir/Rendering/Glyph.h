@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Asciir/Core/Core.h"
+
+namespace Asciir
+{
+	class UTF8Char;
+
+	namespace detail
+	{
+		/// @brief builds the null terminated strings of the first count ascii characters.
+		template<size_t count>
+		constexpr std::array<std::array<char, 2>, count> asciiGlyphs()
+		{
+			std::array<std::array<char, 2>, count> glyphs = {};
+
+			for (size_t i = 0; i < count; i++)
+				glyphs[i][0] = (char)i;
+
+			return glyphs;
+		}
+	}
+
+	/// @brief process wide table of every symbol used by a tile.
+	///
+	/// each distinct symbol is given a 16 bit id, which is stored in the tiles and textures in place of the UTF-8 bytes.
+	/// the table stores the UTF-8 bytes and the length of each symbol, so it is never recomputed when the symbol is written to the terminal.
+	///
+	/// the ascii characters are not stored in the table, their id is the value of the character.
+	/// id 0 is the null symbol, which has a length of 0.
+	///
+	/// the table is never cleared, so an id stays valid for the rest of the process.
+	/// looking up an existing symbol is lock free, only new symbols lock the table.
+	///
+	class GlyphTable
+	{
+	public:
+		/// @brief the maximum number of distinct symbols, including the ascii characters.
+		static constexpr size_t MAX_GLYPHS = 1 << 16;
+		/// @brief the number of ids reserved for the ascii characters.
+		static constexpr uint16_t ASCII_GLYPHS = 128;
+		/// @brief the maximum size of a UTF-8 character, in bytes.
+		static constexpr size_t MAX_LENGTH = 4;
+
+		/// @brief returns the id of the UTF-8 character, of the given length, adding it to the table if it is not present.
+		/// if the table is full, the id of '?' is returned instead.
+		static uint16_t intern(const char* symbol, size_t length);
+		/// @brief same as intern(const char*, size_t), for a null terminated UTF-8 character.
+		/// only the first character of the string is interned.
+		static uint16_t intern(const char* symbol);
+
+		/// @brief returns the null terminated UTF-8 bytes of the symbol with the passed id.
+		static const char* data(uint16_t id)
+		{
+			return id < ASCII_GLYPHS ? s_ascii[id].data() : s_entries[id].bytes;
+		}
+
+		/// @brief returns the number of bytes in the symbol with the passed id.
+		static size_t length(uint16_t id)
+		{
+			return id < ASCII_GLYPHS ? (id != 0) : s_entries[id].length;
+		}
+
+		/// @brief returns the number of symbols currently in the table, including the ascii characters.
+		static size_t size();
+
+	protected:
+		struct Entry
+		{
+			char bytes[MAX_LENGTH + 1];
+			uint8_t length;
+		};
+
+		// the ascii characters as null terminated strings
+		static constexpr std::array<std::array<char, 2>, ASCII_GLYPHS> s_ascii = detail::asciiGlyphs<ASCII_GLYPHS>();
+
+		// zero initialized, so the table does not take up any space in the executable
+		static inline Entry s_entries[MAX_GLYPHS] = {};
+	};
+
+	/// @brief a single symbol of a tile, stored as its id in the GlyphTable.
+	///
+	/// constructing a Glyph from a non ascii symbol adds it to the GlyphTable, if it has not been used before.
+	/// comparing two glyphs is a single integer comparison.
+	///
+	class Glyph
+	{
+	public:
+		/// @brief constructs the null symbol, same as UTF8Char().
+		Glyph() = default;
+
+		/// @brief constructs a Glyph from the given character
+		Glyph(char c)
+			: m_id((unsigned char)c < GlyphTable::ASCII_GLYPHS ? (uint16_t)c : GlyphTable::intern(&c, 1)) {}
+		/// @brief constructs a Glyph from the given wide character
+		Glyph(wchar_t wc);
+		/// @brief constructs a Glyph from the given UTF-8 binary sequence, which must contain one or less characters.
+		/// any characters after the first one are ignored.
+		Glyph(const char* c)
+			: m_id(GlyphTable::intern(c)) {}
+		/// @brief constructs a Glyph from the given UTF8Char
+		Glyph(const UTF8Char& symbol);
+
+		/// @brief constructs a Glyph from an id previously returned by id().
+		static Glyph fromId(uint16_t id)
+		{
+			Glyph glyph;
+			glyph.m_id = id;
+			return glyph;
+		}
+
+		/// @brief returns the id of the symbol in the GlyphTable.
+		uint16_t id() const { return m_id; }
+		/// @brief returns the null terminated UTF-8 bytes of the symbol.
+		const char* data() const { return GlyphTable::data(m_id); }
+		/// @brief returns the number of bytes in the symbol, 0 for the null symbol.
+		size_t length() const { return GlyphTable::length(m_id); }
+
+		/// @brief retrieves a null terminated c_str containing the UTF-8 character
+		operator const char* () const { return data(); }
+
+		bool operator==(const Glyph& other) const { return m_id == other.m_id; }
+		bool operator!=(const Glyph& other) const { return m_id != other.m_id; }
+		bool operator==(char c) const { return *this == Glyph(c); }
+		bool operator!=(char c) const { return !(*this == c); }
+		bool operator==(const char* c_str) const { return *this == Glyph(c_str); }
+		bool operator!=(const char* c_str) const { return !(*this == c_str); }
+
+	protected:
+		uint16_t m_id = 0;
+	};
+}
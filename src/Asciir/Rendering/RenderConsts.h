@@ -17,7 +17,7 @@ namespace Asciir
 	constexpr unsigned char IS_YELLOW = 0b0011;
 	constexpr unsigned char IS_MAGENTA = 0b0101;
 	constexpr unsigned char IS_CYAN = 0b0110;
-	constexpr unsigned char IS_WHITE = 0b1111;
+	constexpr unsigned char IS_WHITE = 0b0111;
 	constexpr unsigned char IS_IBLACK = 0b1000;
 	constexpr unsigned char IS_IRED = 0b1001;
 	constexpr unsigned char IS_IGREEN = 0b1010;
@@ -13,24 +13,29 @@ namespace Asciir
 {
 	TerminalRenderer* Renderer::s_renderer = nullptr;
 	const AsciiAttr* Renderer::s_attr_handler = nullptr;
-	std::vector<Renderer::QueueElem>* Renderer::s_submit_queue = new std::vector<Renderer::QueueElem>;
-	std::vector<Renderer::QueueElem>* Renderer::s_render_queue = new std::vector<Renderer::QueueElem>;
+	Renderer::RenderQueue* Renderer::s_submit_queue = new Renderer::RenderQueue;
+	Renderer::RenderQueue* Renderer::s_render_queue = new Renderer::RenderQueue;
 	DeltaTime Renderer::s_min_dt = 0;
 
 	void Renderer::init()
 	{
 		s_renderer = &ARApp::getApplication()->getTermRenderer();
 		s_attr_handler = &s_renderer->getAttrHandler();
+
+		// threads may have been set before the renderer was initialized
+		if (getThreads() > 0)
+			s_renderer->setEncodeThreads(getThreads());
 	}
 
 
 	void Renderer::setThreads(uint32_t thread_count)
 	{
 		// TODO: thread_count 1 should be the same as 0
-		m_render_thread_pool.resize(thread_count, ETH::LThread(&renderThrd));
+		m_render_thread_pool.resize(thread_count);
+		m_block_queues = std::make_unique<BlockQueue[]>(thread_count);
 
-		for (ETH::LThread& thrd : m_render_thread_pool)
-			thrd.start();
+		if (s_renderer)
+			s_renderer->setEncodeThreads(thread_count);
 	}
 
 	Tile Renderer::drawMeshData(Renderer::MeshData& data, TInt x, TInt y)
@@ -41,17 +46,40 @@ namespace Asciir
 			return Tile::emptyTile();
 	}
 
-	Tile Renderer::drawShaderData(ShaderData& data, TInt x, TInt y, const DeltaTime& time_since_start, size_t frames_since_start)
+	static bool shaderCovers(Renderer::ShaderData& data, TInt x, TInt y)
+	{
+		return data.shader->size() == TermVert(-1, -1) || (data.visible.isInsideGrid(Coord(x, y)) && Quad(data.shader->size()).isInsideGrid(Coord(x, y), data.transform));
+	}
+
+	Tile Renderer::drawShaderData(ShaderData& data, ShaderSpan& span, TInt x, TInt y, const DeltaTime& time_since_start, size_t frames_since_start)
 	{
+		if (span.y == y && x >= span.begin && x < span.end)
+			return span.tiles[x - span.begin];
+
 		// check if inside visible quad before doing anything else
-		if (data.shader->size() == TermVert(-1, -1) || data.visible.isInsideGrid(Coord(x, y)) && Quad(data.shader->size()).isInsideGrid(Coord(x, y), data.transform))
-		{
-			return data.shader->readTile(data.transform.reverseTransformGrid({ x, y }), time_since_start, frames_since_start);
-		}
-		else
-		{
+		if (!shaderCovers(data, x, y))
 			return Tile::emptyTile();
-		}
+
+		TermVert shader_begin = data.transform.reverseTransformGrid({ x, y });
+
+		// the run continues as long as the tiles are covered by the shader, and map to consecutive tiles in the same row of the shader.
+		// this is always the case for transforms without rotation or scaling, apart from rounding errors.
+		TInt block_end = std::min((TInt)((x / s_curr_bin_size + 1) * s_curr_bin_size), (TInt)s_renderer->drawWidth());
+		TInt end = x + 1;
+
+		while (end < block_end && shaderCovers(data, end, y) && TermVert(data.transform.reverseTransformGrid({ end, y })) == shader_begin + TermVert(end - x, 0))
+			end++;
+
+		span.y = y;
+		span.begin = x;
+		span.end = end;
+
+		if (span.tiles.size() < (size_t)(end - x))
+			span.tiles.resize(end - x);
+
+		data.shader->readSpan(shader_begin.y, shader_begin.x, shader_begin.x + (end - x), time_since_start, frames_since_start, span.tiles.data());
+
+		return span.tiles[0];
 	}
 
 	Tile Renderer::drawTileData(TileData& data, TInt x, TInt y)
@@ -62,39 +90,49 @@ namespace Asciir
 			return Tile::emptyTile();
 	}
 
-	void Renderer::drawClearData(ClearData& data)
+	// if this is true, no matter what the next tile will be, it will have no effect on the final result.
+	static bool isOpaque(const Tile& tile)
 	{
-		AR_ASSERT_MSG(data.background_colour.alpha == UCHAR_MAX, "Background colour must be 100% opaque (alpha = 255), got: ", data.background_colour.alpha, " as the alpha value");
-		s_renderer->clearTerminal(data);
+		return !tile.is_empty && tile.background_colour.alpha == 255 && tile.colour.alpha == 255 && tile.symbol != '\0';
 	}
 
 	void Renderer::drawTile(TInt x, TInt y, const DeltaTime& dt, size_t df)
 	{
 		Tile result_tile = Tile::emptyTile();
 
-		for (size_t i = 0; i < s_render_queue->size(); i++)
+		const std::vector<RenderCommand>& bin = s_render_bins[(y / s_curr_bin_size) * s_bin_columns + x / s_curr_bin_size];
+		RenderQueue& queue = *s_render_queue;
+
+		bool opaque = false;
+
+		for (size_t i = 0; i < bin.size() && !opaque; i++)
 		{
-			size_t ri = (s_render_queue->size() - 1 - i);
-			switch (s_render_queue->at(ri).index())
+			size_t index = bin.size() - 1 - i;
+			const RenderCommand& command = bin[index];
+
+			switch (command.type)
 			{
-				case 0: // mesh
-					result_tile = Tile::blend(drawMeshData(std::get<MeshData>(s_render_queue->at(ri)), x, y), result_tile);
+				case CommandType::MESH:
+					result_tile = Tile::blend(drawMeshData(queue.meshes[command.index], x, y), result_tile);
 					break;
-				case 1: // shader
-					result_tile = Tile::blend(drawShaderData(std::get<ShaderData>(s_render_queue->at(ri)), x, y, dt, df), result_tile);
+				case CommandType::SHADER:
+					result_tile = Tile::blend(drawShaderData(queue.shaders[command.index], s_shader_spans[index], x, y, dt, df), result_tile);
 					break;
-				case 2: // tile
-					result_tile = Tile::blend(drawTileData(std::get<TileData>(s_render_queue->at(ri)), x, y), result_tile);
+				case CommandType::TILE:
+					result_tile = Tile::blend(drawTileData(queue.tiles[command.index], x, y), result_tile);
 					break;
-				case 3: // clear
-					result_tile = Tile::blend(std::get<ClearData>(s_render_queue->at(ri)), result_tile);
+				case CommandType::CLEAR:
+					result_tile = Tile::blend(queue.clears[command.index], result_tile);
 					break;
 			}
 
-			// if this is true, no matter what the next tile will be, it will have no effect on the final result, so just skip the rest of the render queue.
-			if (!result_tile.is_empty && result_tile.background_colour.alpha == 255 && result_tile.colour.alpha == 255 && result_tile.symbol != '\0')
-				break;
+			// skip the rest of the commands, if nothing below this tile can be seen.
+			opaque = isOpaque(result_tile);
 		}
+
+		// the clear tile is below every command
+		if (!opaque && queue.has_clear)
+			result_tile = Tile::blend(queue.clear_tile, result_tile);
 		
 		s_renderer->drawTile(x, y, result_tile);
 	}
@@ -109,7 +147,7 @@ namespace Asciir
 	// should this be a ref to mesh???
 	void Renderer::submit(const Mesh& mesh, Tile tile, Transform transform)
 	{
-		MeshData data = MeshData{ mesh, tile };
+		MeshData data = MeshData{ mesh, tile, {} };
 
 		data.mesh.transform(transform);
 
@@ -157,22 +195,58 @@ namespace Asciir
 		submitToQueue(TileData{ tile, pos });
 	}
 
-	void Renderer::submitToQueue(QueueElem new_elem)
+	// pushes the data to the command buffer, and its position to the order of the queue
+	template<typename T>
+	static void pushCommand(Renderer::RenderQueue& queue, std::vector<T>& buffer, Renderer::CommandType type, const T& data)
 	{
-		s_submit_queue->push_back(new_elem);
+		queue.order.push_back({ type, (uint32_t)buffer.size() });
+		buffer.push_back(data);
 
 #if AR_RENDER_QUEUE_MAX != -1
 		static_assert(AR_RENDER_QUEUE_MAX > 0);
 
-		AR_ASSERT_VOLATILE(s_renderer_queue.capacity() > AR_RENDER_QUEUE_MAX,
+		AR_ASSERT_VOLATILE(queue.size() <= AR_RENDER_QUEUE_MAX,
 			"Number of elements submitted to the render queue surpassed the maximum limit")
 #endif
 	}
 
+	void Renderer::submitToQueue(const MeshData& data)
+	{
+		pushCommand(*s_submit_queue, s_submit_queue->meshes, CommandType::MESH, data);
+	}
+
+	void Renderer::submitToQueue(const ShaderData& data)
+	{
+		pushCommand(*s_submit_queue, s_submit_queue->shaders, CommandType::SHADER, data);
+	}
+
+	void Renderer::submitToQueue(const TileData& data)
+	{
+		pushCommand(*s_submit_queue, s_submit_queue->tiles, CommandType::TILE, data);
+	}
+
+	void Renderer::submitToQueue(const ClearData& data)
+	{
+		AR_ASSERT_MSG(data.background_colour.alpha == UCHAR_MAX, "Background colour must be 100% opaque (alpha = 255), got: ", data.background_colour.alpha, " as the alpha value");
+
+		// the earlier commands can still be seen through a clear tile which is not opaque, so it has to be blended over them.
+		if (!isOpaque(data))
+		{
+			pushCommand(*s_submit_queue, s_submit_queue->clears, CommandType::CLEAR, data);
+			return;
+		}
+
+		// nothing submitted before the clear can be seen, so there is no reason to render it.
+		s_submit_queue->clear();
+
+		s_submit_queue->clear_tile = data;
+		s_submit_queue->has_clear = true;
+	}
+
 	Tile Renderer::viewTile(TermVert pos)
 	{
 		AR_ASSERT_MSG(pos.x >= 0 && (size_t)pos.x < size().x && pos.y >= 0 && (size_t)pos.y < size().y, "Cannot view tile outside of terminal size");
-		return s_renderer->getTile((TermVert)pos).current;
+		return s_renderer->viewTile((TermVert)pos).current;
 	}
 
 	Texture2D Renderer::grabScreen(TermVert rect_start, TermVert rect_offset)
@@ -180,20 +254,20 @@ namespace Asciir
 		CT_MEASURE_N("Grab Screen");
 
 		// check for invalid arguments
-		AR_ASSERT_MSG(rect_offset.x > 0 || rect_offset.x == -1 && rect_offset.y > 0 || rect_offset.y == -1,
+		AR_ASSERT_MSG((rect_offset.x > 0 || rect_offset.x == -1) && (rect_offset.y > 0 || rect_offset.y == -1),
 			"Invalid grab screen region. rect_offset has invalid values: ", rect_offset);
 
 		// grab region is out of bounds, return empty texture
-		if (rect_start.x >= Renderer::size().x || rect_start.y >= Renderer::size().y)
+		if ((size_t)rect_start.x >= Renderer::size().x || (size_t)rect_start.y >= Renderer::size().y)
 			return {};
 
 		// set -1 to the end of the terminal, or clamp the grab region to fit inside the terminal
 
-		if (rect_offset.x == -1 || rect_start.x + rect_offset.x > Renderer::size().x)
+		if (rect_offset.x == -1 || (size_t)(rect_start.x + rect_offset.x) > Renderer::size().x)
 			rect_offset.x = (TInt) Renderer::size().x - rect_start.x - 1;
 
 
-		if (rect_offset.y == -1 || rect_start.y + rect_offset.y > Renderer::size().y)
+		if (rect_offset.y == -1 || (size_t)(rect_start.y + rect_offset.y) > Renderer::size().y)
 			rect_offset.y = (TInt) Renderer::size().y - rect_start.y - 1;
 
 
@@ -238,13 +312,11 @@ namespace Asciir
 		return (TInt)s_renderer->drawHeight();
 	}
 
-	void Renderer::swapQueues()
+	// shrinks the capacity of the buffer, if it is much larger than the size of the last frame.
+	template<typename T>
+	static void fitQueueBuffer(std::vector<T>& buffer, size_t queue_size)
 	{
-		std::swap(s_submit_queue, s_render_queue);
-
-		size_t queue_size = s_render_queue->size();
-
-		if (queue_size + AR_RENDER_QUEUE_MARGIN < s_submit_queue->capacity())
+		if (queue_size + AR_RENDER_QUEUE_MARGIN < buffer.capacity())
 		{
 			size_t new_capacity = queue_size;
 
@@ -260,24 +332,110 @@ namespace Asciir
 
 		#endif
 
-			s_submit_queue->shrink_to_fit();
-			s_submit_queue->reserve(new_capacity);
+			buffer.shrink_to_fit();
+			buffer.reserve(new_capacity);
 		}
 	}
 
-	void Renderer::flushRenderQueue(const DeltaTime& time_since_start, size_t frames_since_start)
+	void Renderer::swapQueues()
 	{
-		AR_CORE_INFO("RENDER FRAME");
-		// if only one thread is needed, avoid creating a seperate thread
-		if ((uint32_t) s_renderer->drawWidth() * (uint32_t) s_renderer->drawHeight() <= thrd_tile_count || m_render_thread_pool.size() == 0)
+		std::swap(s_submit_queue, s_render_queue);
+
+		fitQueueBuffer(s_submit_queue->meshes, s_render_queue->meshes.size());
+		fitQueueBuffer(s_submit_queue->shaders, s_render_queue->shaders.size());
+		fitQueueBuffer(s_submit_queue->tiles, s_render_queue->tiles.size());
+		fitQueueBuffer(s_submit_queue->clears, s_render_queue->clears.size());
+		fitQueueBuffer(s_submit_queue->order, s_render_queue->order.size());
+	}
+
+	// retrieves the tiles the passed visible quad can cover, clamped to the terminal.
+	// the quad is expanded by a tile in every direction, as Quad::isInsideGrid rounds the coordinates to the grid.
+	static void visibleTiles(const Quad& visible, TermVert& top_left, TermVert& bottom_right)
+	{
+		// the coordinates are clamped before they are converted, so quads far outside the terminal do not overflow a TInt.
+		Coord min_coord = Coord(top_left.x - 1, top_left.y - 1);
+		Coord max_coord = Coord(bottom_right.x + 1, bottom_right.y + 1);
+
+		top_left.x = (TInt)std::clamp(floor(visible.offset.x) - 1, min_coord.x, max_coord.x);
+		top_left.y = (TInt)std::clamp(floor(visible.offset.y) - 1, min_coord.y, max_coord.y);
+		bottom_right.x = (TInt)std::clamp(ceil(visible.offset.x + visible.size.x) + 1, min_coord.x, max_coord.x);
+		bottom_right.y = (TInt)std::clamp(ceil(visible.offset.y + visible.size.y) + 1, min_coord.y, max_coord.y);
+	}
+
+	void Renderer::binRenderQueue()
+	{
+		CT_MEASURE_N("Bin Render Queue");
+
+		TInt width = (TInt)s_renderer->drawWidth();
+		TInt height = (TInt)s_renderer->drawHeight();
+
+		s_curr_bin_size = std::max(bin_size, (TInt)1);
+		s_bin_columns = (width + s_curr_bin_size - 1) / s_curr_bin_size;
+		TInt bin_rows = (height + s_curr_bin_size - 1) / s_curr_bin_size;
+
+		// the bins keep their capacity between frames, so they are only reallocated if the queue grows.
+		s_render_bins.resize((size_t)s_bin_columns * bin_rows);
+
+		for (std::vector<RenderCommand>& bin : s_render_bins)
+			bin.clear();
+
+		for (const RenderCommand& command : s_render_queue->order)
 		{
-			for (TInt x = 0; x < s_renderer->drawWidth(); x++)
+			// the range of tiles the command can cover, defaults to the entire terminal
+			TermVert top_left(0, 0);
+			TermVert bottom_right(width - 1, height - 1);
+
+			switch (command.type)
 			{
-				for (TInt y = 0; y < s_renderer->drawHeight(); y++)
+				case CommandType::MESH:
+					visibleTiles(s_render_queue->meshes[command.index].visible, top_left, bottom_right);
+					break;
+				case CommandType::SHADER:
 				{
-					drawTile(x, y, time_since_start, frames_since_start);
+					const ShaderData& data = s_render_queue->shaders[command.index];
+
+					if (data.shader->size() != TermVert(-1, -1))
+						visibleTiles(data.visible, top_left, bottom_right);
+					break;
 				}
+				case CommandType::TILE:
+					top_left = s_render_queue->tiles[command.index].pos;
+					bottom_right = top_left;
+					break;
+				case CommandType::CLEAR:
+					// a clear covers the entire terminal
+					break;
 			}
+
+			top_left.x = std::max(top_left.x, (TInt)0);
+			top_left.y = std::max(top_left.y, (TInt)0);
+			bottom_right.x = std::min(bottom_right.x, (TInt)(width - 1));
+			bottom_right.y = std::min(bottom_right.y, (TInt)(height - 1));
+
+			// the command is outside the terminal
+			if (top_left.x > bottom_right.x || top_left.y > bottom_right.y)
+				continue;
+
+			for (TInt by = top_left.y / s_curr_bin_size; by <= bottom_right.y / s_curr_bin_size; by++)
+				for (TInt bx = top_left.x / s_curr_bin_size; bx <= bottom_right.x / s_curr_bin_size; bx++)
+					s_render_bins[(size_t)by * s_bin_columns + bx].push_back(command);
+		}
+	}
+
+	void Renderer::flushRenderQueue(const DeltaTime& time_since_start, size_t frames_since_start)
+	{
+		AR_CORE_INFO("RENDER FRAME");
+
+		binRenderQueue();
+
+		// the screen blocks are the same as the bins, so every tile in a block visits the same commands.
+		uint32_t blocks = (uint32_t)s_render_bins.size();
+
+		// if only one thread is needed, avoid creating a seperate thread
+		if ((uint32_t) s_renderer->drawWidth() * (uint32_t) s_renderer->drawHeight() <= thrd_tile_count || m_render_thread_pool.size() == 0)
+		{
+			for (uint32_t block = 0; block < blocks; block++)
+				drawBlock(block, time_since_start, frames_since_start);
 		}
 		else
 		{
@@ -287,48 +445,126 @@ namespace Asciir
 			thrds = std::min((uint32_t) m_render_thread_pool.size(), thrds);
 
 			AR_CORE_INFO("Using ", thrds, " threads to render the current frame!");
-			
-			m_avaliable_tile = 0;
+
+			// give each thread an equal share of the blocks, the rest is balanced by stealing
+			for (uint32_t i = 0; i < thrds; i++)
+			{
+				uint64_t begin = (uint64_t)blocks * i / thrds;
+				uint64_t end = (uint64_t)blocks * (i + 1) / thrds;
+
+				m_block_queues[i].range.store(end << 32 | begin, std::memory_order_relaxed);
+			}
+
+			m_curr_thrds = thrds;
 
 			m_curr_dt = time_since_start;
 			m_curr_df = frames_since_start;
 
-			for (uint32_t i = 0; i < thrds; i++)
-				m_render_thread_pool[i].startLoop();
-
-			for (uint32_t i = 0; i < thrds; i++)
-				m_render_thread_pool[i].joinLoop();
+			m_render_thread_pool.dispatch(thrds);
+			m_render_thread_pool.wait();
 		}
 
 		s_render_queue->clear();
 	}
 
-	void Renderer::renderThrd()
+	bool Renderer::popBlock(BlockQueue& queue, uint32_t& block)
 	{
-		// should run until the avaliable tiles have run out
+		uint64_t range = queue.range.load(std::memory_order_acquire);
+
 		while (true)
 		{
-			uint32_t current_tile;
+			uint32_t begin = (uint32_t)range;
+			uint32_t end = (uint32_t)(range >> 32);
+
+			if (begin >= end)
+				return false;
 
+			if (queue.range.compare_exchange_weak(range, (uint64_t)end << 32 | (begin + 1), std::memory_order_acq_rel, std::memory_order_acquire))
 			{
-				std::unique_lock<std::mutex> lock(m_mutex);
-				
-				if (!(m_avaliable_tile < (uint32_t)s_renderer->drawWidth() * (uint32_t)s_renderer->drawHeight()))
-					break;
+				block = begin;
+				return true;
+			}
+		}
+	}
+
+	bool Renderer::stealBlocks(BlockQueue& queue)
+	{
+		while (true)
+		{
+			// find the thread with the most blocks left
+			BlockQueue* victim = nullptr;
+			uint64_t victim_range = 0;
+			uint32_t most_blocks = 0;
 
-				current_tile = m_avaliable_tile;
-				m_avaliable_tile += thrd_tile_count;
+			for (uint32_t i = 0; i < m_curr_thrds; i++)
+			{
+				uint64_t range = m_block_queues[i].range.load(std::memory_order_acquire);
+				uint32_t begin = (uint32_t)range;
+				uint32_t end = (uint32_t)(range >> 32);
+
+				if (begin < end && end - begin > most_blocks)
+				{
+					victim = &m_block_queues[i];
+					victim_range = range;
+					most_blocks = end - begin;
+				}
 			}
 
-			// the loop should never go outside the draw range, so this is here to make sure it does not do that :)
-			uint32_t end = std::min(current_tile + thrd_tile_count, (uint32_t) s_renderer->drawWidth() * (uint32_t) s_renderer->drawHeight());
+			if (!victim)
+				return false;
 
-			for (uint32_t i = current_tile; i < end; i++)
+			uint32_t begin = (uint32_t)victim_range;
+			uint32_t end = (uint32_t)(victim_range >> 32);
+
+			// the thief takes the larger half, so the last block of a queue can also be stolen.
+			uint32_t middle = end - (end - begin + 1) / 2;
+
+			// if the victim took or lost blocks in the meantime, search again.
+			if (victim->range.compare_exchange_strong(victim_range, (uint64_t)middle << 32 | begin, std::memory_order_acq_rel, std::memory_order_acquire))
 			{
-				//       calculate the x and y coordinates from the index
-				drawTile((TInt)(i % s_renderer->drawWidth()), (TInt)(i / s_renderer->drawWidth()), m_curr_dt, m_curr_df);
+				// no other thread modifies an empty queue, so the stolen blocks can just be stored.
+				queue.range.store((uint64_t)end << 32 | middle, std::memory_order_release);
+				return true;
 			}
 		}
 	}
 
+	void Renderer::drawBlock(uint32_t block, const DeltaTime& dt, size_t df)
+	{
+		TInt block_x = (TInt)(block % s_bin_columns) * s_curr_bin_size;
+		TInt block_y = (TInt)(block / s_bin_columns) * s_curr_bin_size;
+
+		TInt end_x = std::min((TInt)(block_x + s_curr_bin_size), (TInt)s_renderer->drawWidth());
+		TInt end_y = std::min((TInt)(block_y + s_curr_bin_size), (TInt)s_renderer->drawHeight());
+
+		// the spans of the previous block belong to the commands of another bin.
+		size_t command_count = s_render_bins[block].size();
+
+		if (s_shader_spans.size() < command_count)
+			s_shader_spans.resize(command_count);
+
+		for (size_t i = 0; i < command_count; i++)
+			s_shader_spans[i].y = -1;
+
+		for (TInt y = block_y; y < end_y; y++)
+			for (TInt x = block_x; x < end_x; x++)
+				drawTile(x, y, dt, df);
+	}
+
+	void Renderer::renderThrd(uint32_t worker)
+	{
+		BlockQueue& queue = m_block_queues[worker];
+
+		// should run until there are no blocks left to render or steal
+		while (true)
+		{
+			uint32_t block;
+
+			if (popBlock(queue, block))
+				drawBlock(block, m_curr_dt, m_curr_df);
+			else if (!stealBlocks(queue))
+				break;
+		}
+	}
+
 }
\ No newline at end of file
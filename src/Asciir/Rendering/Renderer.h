@@ -7,6 +7,7 @@
 
 #include "Asciir/Maths/Vertices.h"
 #include "Asciir/Core/Application.h"
+#include "Asciir/Core/WorkerPool.h"
 
 namespace Asciir
 {
@@ -82,11 +83,61 @@ namespace Asciir
 			TermVert pos;
 		};
 
+		/// @brief the tile the terminal should be cleared with, before anything else is rendered.
 		typedef Tile ClearData;
 
-		/// @brief the datatype used in the render queue
-		/// mesh data, texture data, point data or clear data
-		typedef std::variant<MeshData, ShaderData, TileData, ClearData> QueueElem;
+		/// @brief the type of a command in the render queue, decides which command buffer it is stored in.
+		enum class CommandType : uint8_t
+		{
+			MESH,
+			SHADER,
+			TILE,
+			CLEAR
+		};
+
+		/// @brief refers to a single command in one of the command buffers of a RenderQueue.
+		struct RenderCommand
+		{
+			CommandType type;
+			/// @brief the index of the command in the buffer of its type.
+			uint32_t index;
+		};
+
+		/// @brief the commands submitted for a single frame.
+		/// 
+		/// each type of command is stored in its own buffer, and the order they were submitted in is stored seperatly, as a list of RenderCommands.
+		/// 
+		/// an opaque ClearData is not stored as a command, as it hides everything submitted before it.
+		/// instead, submitting an opaque clear discards all the current commands, and the clear tile is used as the background of the frame.
+		/// a clear tile which is not opaque, e.g. a translucent foreground or no symbol, is blended over the earlier commands, so it is stored as a command covering the entire terminal.
+		/// 
+		struct RenderQueue
+		{
+			std::vector<MeshData> meshes;
+			std::vector<ShaderData> shaders;
+			std::vector<TileData> tiles;
+			std::vector<ClearData> clears;
+			/// @brief the commands in the order they were submitted
+			std::vector<RenderCommand> order;
+
+			/// @brief the tile the frame is initialized with, only used if has_clear is true.
+			ClearData clear_tile;
+			bool has_clear = false;
+
+			/// @brief returns the number of commands in the queue
+			size_t size() const { return order.size(); }
+
+			/// @brief removes all commands and the clear tile, without freeing any memory.
+			void clear()
+			{
+				meshes.clear();
+				shaders.clear();
+				tiles.clear();
+				clears.clear();
+				order.clear();
+				has_clear = false;
+			}
+		};
 
 		/// @brief initialize the renderer.
 		/// setsup all the static references that have been setup before the renderer.
@@ -95,19 +146,36 @@ namespace Asciir
 		/// @brief defaults to number of avaliable threads on the system. @see setThreads()
 		static void setThreads() { setThreads(std::thread::hardware_concurrency()); }
 		/// @brief sets the number of threads to be used when rendering the frame.
+		/// the TerminalRenderer uses the same number of threads for encoding the frame, @see TerminalRendererInterface::setEncodeThreads().
 		/// @note everytime this function is called, all the threads are reallocated and restarted, so call this function as little as possible, preferably only once at the application start.
 		static void setThreads(uint32_t thread_count);
 		/// @brief returns the number of threads used when rendering a frame.
-		static uint32_t getThreads() { return (uint32_t) m_render_thread_pool.size(); }
-
-		/// @brief the number of tiles to be processed by a thread, at a time.  
+		static uint32_t getThreads() { return m_render_thread_pool.size(); }
+		/// @brief retrieves the wake latency, idle time and busy time of each render thread, accumulated since the last resetThreadMetrics() call.
+		/// @see WorkerPool::getMetrics()
+		static std::vector<WorkerPool::WorkerMetrics> getThreadMetrics() { return m_render_thread_pool.getMetrics(); }
+		/// @brief resets the metrics returned by getThreadMetrics().
+		/// @note increments made by a render thread whilst the metrics are reset may be lost, so while rendering, prefer sampling getThreadMetrics() and using the difference between samples.
+		static void resetThreadMetrics() { m_render_thread_pool.resetMetrics(); }
+
+		/// @brief the minimum number of tiles a render thread should have.
+		/// 
+		/// the frame is rendered with at most width * height / thrd_tile_count threads, and on the calling thread if this is less than 2.
 		/// 
 		/// example:
-		/// a frame with the dimenstions 10 x 10 has 5 threads, and the thread length is 10.  
-		/// In this case, each thread will render a column at a time, before moving along to the next avaliable tiles.
+		/// a frame with the dimensions 100 x 40 and a thrd_tile_count of 256, will be rendered by at most 15 threads.
+		/// 
+		/// the threads render the frame in blocks of bin_size x bin_size tiles, @see renderThrd().
 		/// 
 		static inline uint32_t thrd_tile_count = 256;
 
+		/// @brief the width and height, in tiles, of the screen blocks the render queue is binned into, before the frame is rendered.
+		/// 
+		/// each tile only visits the commands binned to its block, instead of the entire render queue.
+		/// smaller blocks skip more commands, but a command is stored once for every block it overlaps.
+		/// 
+		static inline TInt bin_size = 16;
+
 		// submit functions
 		/// @brief submits the given mesh data to the render queue
 		// TODO: should this be a reference? mesh might be modified whilst the renderer is rendering.
@@ -117,7 +185,12 @@ namespace Asciir
 		static void submit(Ref<TShader> shader, Transform transform = NoTransform);
 		/// @brief submits the given tile to the render queue
 		static void submit(TermVert pos, Tile tile);
-		static void submitToQueue(QueueElem new_elem);
+		/// @brief pushes the given data to the end of the render queue.
+		static void submitToQueue(const MeshData& data);
+		static void submitToQueue(const ShaderData& data);
+		static void submitToQueue(const TileData& data);
+		/// @brief discards everything in the render queue, and clears the frame with the given tile.
+		static void submitToQueue(const ClearData& data);
 		static void submitRect(s_Coords<2> verts, Tile tile);
 		static Tile viewTile(TermVert pos);
 
@@ -203,30 +276,74 @@ namespace Asciir
 		/// @param frames_since_start the number of frames rendered up until now
 		static void flushRenderQueue(const DeltaTime& time_since_start, size_t frames_since_start);
 
+		/// @brief sorts the render queue into screen blocks of bin_size x bin_size tiles.
+		/// every block stores each command that can cover a tile inside the block, in the order they were submitted.
+		/// shaders without a size are stored in every block.
+		static void binRenderQueue();
+
 		/// @brief global delta time value for use by render threads
 		/// should be set at the start of every render, so all threads have the same value
 		static inline DeltaTime m_curr_dt;
 		/// @brief global delta frame value for use by render threads
 		static inline size_t m_curr_df;
 		/// @brief single thread resbonsible for partially rendering the current frame together with other threads.  
-		static void renderThrd();
+		/// 
+		/// the threads are kept alive in a WorkerPool between frames, and worker is the index of the thread in the pool.
+		/// each thread starts with an equal share of the screen blocks in its BlockQueue, and renders them from the front.
+		/// once its queue is empty, it steals half of the remaining blocks of the thread with the most blocks left,
+		/// so a region which is expensive to render is spread out across all the threads.
+		/// 
+		static void renderThrd(uint32_t worker);
+
+		/// @brief the screen blocks a render thread has left to render, @see renderThrd().
+		/// 
+		/// the index of the first block and one past the last block are packed into the low and high 32 bits of a single atomic,
+		/// so the owning thread can take blocks from the front, whilst other threads steal blocks from the back, without a lock.
+		/// 
+		struct alignas(64) BlockQueue
+		{
+			std::atomic<uint64_t> range = 0;
+		};
+
+		/// @brief the tiles of a shader, read for a run of tiles in a single row, @see drawShaderData().
+		struct ShaderSpan
+		{
+			TInt y = -1;
+			TInt begin = 0;
+			TInt end = 0;
+			std::vector<Tile> tiles;
+		};
+
+		/// @brief takes the first block of the queue, returns false if the queue is empty.
+		static bool popBlock(BlockQueue& queue, uint32_t& block);
+		/// @brief moves half of the remaining blocks of the thread with the most blocks left, to the passed queue, which must be empty.
+		/// returns false if there were no blocks left to steal.
+		static bool stealBlocks(BlockQueue& queue);
+		/// @brief renders every tile in the given screen block.
+		static void drawBlock(uint32_t block, const DeltaTime& dt, size_t df);
 
 		// TODO: these should be modified to return a tile, instead of rendering the entire thing.
 		/// @brief render the given mesh data
 		static Tile drawMeshData(MeshData& data, TInt x, TInt y);
 		/// @brief render the given shader data
-		static Tile drawShaderData(ShaderData& data, TInt x, TInt y, const DeltaTime& time_since_start, size_t frames_since_start);
+		/// 
+		/// the first time a tile of a row is drawn, the shader is read for the entire run of tiles it covers, from x to the end of the screen block row,
+		/// with a single Shader2D::readSpan() call. the following tiles of the run are then taken from the span.
+		/// 
+		/// @note this means tiles which end up hidden by an opaque command above the shader, may still be read from the shader.
+		static Tile drawShaderData(ShaderData& data, ShaderSpan& span, TInt x, TInt y, const DeltaTime& time_since_start, size_t frames_since_start);
 		/// @brief render the given tile data
 		static Tile drawTileData(TileData& data, TInt x, TInt y);
-		/// @brief render the given clear data
-		static void drawClearData(ClearData& data);
 
 		/// @brief renders a single tile of the frame.  
 		///	
-		/// only renders neccesary QueueElems, meaning it skips any elements that do not contain the tile, and also skips any elements that do not have an effect on the final result.  
-		/// a QueueElem is determined to have no effect, if the QueueElem above it has an alpha value of 255, and is not empty.
+		/// only renders neccesary commands, meaning it skips any commands that do not contain the tile, and also skips any commands that do not have an effect on the final result.  
+		/// a command is determined to have no effect, if the command above it has an alpha value of 255, and is not empty.
 		/// 
-		/// the QueueElems get rendered in order of last in, first out, meaning the latest submitted QueueElem will be rendered first.
+		/// the commands get rendered in order of last in, first out, meaning the latest submitted command will be rendered first.
+		/// the clear tile of the queue, if any, is rendered below all the commands.
+		/// 
+		/// only the commands binned to the screen block containing the tile are visited, @see binRenderQueue().
 		/// 
 		static void drawTile(TInt y, TInt x, const DeltaTime& dt, size_t df);
 
@@ -239,19 +356,30 @@ namespace Asciir
 
 		static TerminalRenderer* s_renderer;
 		static const AsciiAttr* s_attr_handler;
-		static std::vector<QueueElem>* s_submit_queue;
-		static std::vector<QueueElem>* s_render_queue;
+		static RenderQueue* s_submit_queue;
+		static RenderQueue* s_render_queue;
 		static arMatrix<Tile> s_visible_terminal;
 
+		/// @brief the render queue commands binned to each screen block, stored row by row. @see binRenderQueue()
+		static inline std::vector<std::vector<RenderCommand>> s_render_bins;
+		/// @brief the bin size used for the current render queue, as bin_size may be changed whilst rendering.
+		static inline TInt s_curr_bin_size = 16;
+		/// @brief the number of screen blocks in a row of s_render_bins.
+		static inline TInt s_bin_columns = 0;
+		/// @brief the current shader span of every command in the screen block being drawn, indexed the same way as its bin.
+		/// each render thread has its own spans, which are reset at the start of every block.
+		static inline thread_local std::vector<ShaderSpan> s_shader_spans;
+
 		/// @brief the app will wait until the minimum delta time is hit, after each update
 		/// @brief DEFAULT: no limit
 		static DeltaTime s_min_dt;
 
 
-		static inline std::mutex m_mutex;
-		static inline std::vector<ETH::LThread> m_render_thread_pool;
-		/// @brief the start position of the next tile chunk that needs to be rendered.
-		static inline std::atomic<uint32_t> m_avaliable_tile;
+		static inline WorkerPool m_render_thread_pool{ &renderThrd };
+		/// @brief the BlockQueue of each render thread, only the first m_curr_thrds are used for the current frame.
+		static inline std::unique_ptr<BlockQueue[]> m_block_queues;
+		/// @brief the number of threads rendering the current frame.
+		static inline uint32_t m_curr_thrds = 0;
 	};
 }
 
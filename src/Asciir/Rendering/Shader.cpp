@@ -4,6 +4,12 @@
 
 namespace Asciir
 {
+	void Shader2D::readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& time_since_start, size_t frames_since_start, Tile* out)
+	{
+		for (TInt x = x_begin; x < x_end; x++)
+			out[x - x_begin] = readTile({ x, y }, time_since_start, frames_since_start);
+	}
+
 	Coord Shader2D::toUV(const TermVert& coord)
 	{
 		if (size() != TermVert(-1, -1))
@@ -23,6 +23,17 @@ namespace Asciir
 		/// @param time_since_start (optional) time value for the shader function. Is automaticly supplied if passed through Renderer::submitShader
 		/// @param frames_since_start (optional) frame value for the shader function. Is automaticly supplied if passed through Renderer::submitShader
 		virtual Tile readTile(TermVert coord, const DeltaTime& time_since_start = 0, size_t frames_since_start = 0) = 0;
+
+		/// @brief reads the tiles from (x_begin, y) up to, but not including, (x_end, y) into out.
+		/// 
+		/// the Renderer uses this for every run of tiles in a row, which are covered by the same shader,
+		/// so a shader can compute anything that only depends on the row once, and process the rest of the row in a tight loop.
+		/// 
+		/// the default implementation calls readTile() for every tile in the span.
+		/// 
+		/// @param out must have room for x_end - x_begin tiles.
+		/// @note an override must produce the same tiles as readTile() would.
+		virtual void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& time_since_start, size_t frames_since_start, Tile* out);
 		
 		/// @brief maps the given coordinate to a 0-1 range in the x and y dimension.
 		/// 
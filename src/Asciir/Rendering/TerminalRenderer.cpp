@@ -1,13 +1,13 @@
 ﻿#include "arpch.h"
 
 #include "TerminalRenderer.h"
+#include "TileDiff.h"
 #include "Asciir/Maths/Lines.h"
 #include "Asciir/Logging/Log.h"
+#include "Asciir/Core/Timing.h"
 
 #ifdef AR_WIN
 #include "Asciir/Platform/Windows/WindowsARAttributes.h"
-#elif defined AR_UNIX
-#include "Asciir/Platform/Unix/UnixARAttributes.h"
 #endif
 
 #include <ChrTrc.h>
@@ -56,16 +56,17 @@ namespace Asciir
 namespace TRInterface
 {
 	TerminalRendererInterface::TerminalRendererInterface(const TerminalRendererInterface::TerminalProps& term_props)
-		: m_title(term_props.title), m_buff_stream(AR_IMPL(this).getBuffer()), m_print_thrd(&TerminalRendererInterface::flushBuffer, this) {}
+		: m_title(term_props.title), m_print_thrd(&TerminalRendererInterface::flushFrame, this), m_arena(term_props.buffer_size), m_flush_arena(term_props.buffer_size) {}
 
 	void TerminalRendererInterface::initRenderer(const TerminalProps& term_props)
 	{
 		// TODO: no need for this to be a pointer
-	#ifdef AR_WIN
 		m_attr_handler = std::make_shared<AsciiAttr>();
-	#elif defined(AR_UNIX)
-		m_attr_handler = std::make_shared<UnixARAttr>();
-	#endif
+		m_attr_handler->setColourMode(term_props.colour_mode, term_props.dithering);
+		setByteBudget(term_props.byte_budget);
+		setRunCompression(term_props.erase_runs, term_props.repeat_runs);
+		setFrameCoalescing(term_props.coalesce_frames);
+		setScrollDetection(term_props.scroll_detection);
 
 		if (term_props.size != TermVert(0, 0))
 			resize(term_props.size);
@@ -75,7 +76,23 @@ namespace TRInterface
 
 	TerminalRendererInterface::~TerminalRendererInterface()
 	{
+		m_print_thrd.joinLoop();
 		m_print_thrd.join();
+
+		for (ETH::LThread& thrd : m_encode_thrds)
+			thrd.join();
+	}
+
+	void TerminalRendererInterface::setEncodeThreads(uint32_t thread_count)
+	{
+		for (ETH::LThread& thrd : m_encode_thrds)
+			thrd.join();
+
+		m_encode_thrds.clear();
+		m_encode_thrds.resize(thread_count, ETH::LThread(&TerminalRendererInterface::encodeThrd, this));
+
+		for (ETH::LThread& thrd : m_encode_thrds)
+			thrd.start();
 	}
 
 	void TerminalRendererInterface::setColour(Colour colour)
@@ -154,7 +171,7 @@ namespace TRInterface
 								was_inside = is_inside;
 								tmp_inside = !is_inside;
 							}
-							else if (other_lsegment.direction.y > 0 != lsegment.direction.y > 0)
+							else if ((other_lsegment.direction.y > 0) != (lsegment.direction.y > 0))
 							{
 								is_corner = true;
 								was_inside = false;
@@ -182,7 +199,7 @@ namespace TRInterface
 
 					is_inside = tmp_inside;
 
-					if (!(is_corner && is_inside) && (is_corner && !is_inside || is_inside || was_inside))
+					if (!(is_corner && is_inside) && ((is_corner && !is_inside) || is_inside || was_inside))
 					{
 						was_inside = false;
 						drawTile({ x, line });
@@ -199,14 +216,66 @@ namespace TRInterface
 
 	void TerminalRendererInterface::clearTerminal(Tile clear_tile)
 	{
-		for (size_t i = 0; i < (size_t)m_tiles.size(); i++)
-			m_tiles.data()[i].current = clear_tile;
+		// only the tiles that actually change are marked as dirty, as the terminal is often cleared every frame.
+		for (TInt y = 0; (size_t)y < drawHeight(); y++)
+		{
+			for (TInt x = 0; (size_t)x < drawWidth(); x++)
+			{
+				if (!m_current.equals(x, y, clear_tile))
+				{
+					m_current.set(x, y, clear_tile);
+					markDirty(x, y);
+				}
+			}
+		}
 	}
 
 	void TerminalRendererInterface::clearRenderTiles()
 	{
-		for (size_t i = 0; i < (size_t)m_tiles.size(); i++)
-			m_tiles.data()[i].last = Tile::emptyTile();
+		m_last.fill(Tile::emptyTile());
+
+		markRowsDirty(0, (TInt)drawHeight());
+	}
+
+	void TerminalRendererInterface::markDirty(TInt x, TInt y)
+	{
+		// the tiles might be drawn from multiple threads at once, so the span is updated with atomic operations.
+		// the span is almost always already large enough after the first tile in a row, in which case no writes happen.
+		std::atomic<TInt>& begin = m_dirty_begin[y];
+		std::atomic<TInt>& end = m_dirty_end[y];
+
+		TInt current_begin = begin.load(std::memory_order_relaxed);
+		while (x < current_begin && !begin.compare_exchange_weak(current_begin, x, std::memory_order_relaxed));
+
+		TInt current_end = end.load(std::memory_order_relaxed);
+		while (x + 1 > current_end && !end.compare_exchange_weak(current_end, (TInt)(x + 1), std::memory_order_relaxed));
+
+		std::atomic<uint64_t>& word = m_dirty_rows[y / DIRTY_WORD_BITS];
+		uint64_t bit = 1ULL << (y % DIRTY_WORD_BITS);
+
+		if (!(word.load(std::memory_order_relaxed) & bit))
+			word.fetch_or(bit, std::memory_order_relaxed);
+	}
+
+	void TerminalRendererInterface::markRowsDirty(TInt begin, TInt end)
+	{
+		for (TInt y = begin; y < end; y++)
+		{
+			m_dirty_begin[y].store(0, std::memory_order_relaxed);
+			m_dirty_end[y].store((TInt)drawWidth(), std::memory_order_relaxed);
+			m_dirty_rows[y / DIRTY_WORD_BITS].fetch_or(1ULL << (y % DIRTY_WORD_BITS), std::memory_order_relaxed);
+		}
+	}
+
+	void TerminalRendererInterface::resizeDirty()
+	{
+		size_t height = drawHeight();
+
+		m_dirty_begin = std::vector<std::atomic<TInt>>(height);
+		m_dirty_end = std::vector<std::atomic<TInt>>(height);
+		m_dirty_rows = std::vector<std::atomic<uint64_t>>((height + DIRTY_WORD_BITS - 1) / DIRTY_WORD_BITS);
+
+		markRowsDirty(0, (TInt)height);
 	}
 
 	void TerminalRendererInterface::setState(Tile tile)
@@ -231,10 +300,14 @@ namespace TRInterface
 
 	void TerminalRendererInterface::drawTile(TInt x, TInt y, const Tile& tile)
 	{
-		AR_ASSERT_MSG(x < drawWidth() && x >= 0 && y < drawHeight() && y >= 0,
+		AR_ASSERT_MSG(x >= 0 && (size_t)x < drawWidth() && y >= 0 && (size_t)y < drawHeight(),
 			"Position ", TermVert(x, y), " is out of bounds. Bounds: ", drawSize());
 
-		m_tiles(y, x).current = tile;
+		if (!m_current.equals(x, y, tile))
+		{
+			m_current.set(x, y, tile);
+			markDirty(x, y);
+		}
 	}
 
 	void TerminalRendererInterface::blendTile(TInt x, TInt y)
@@ -244,18 +317,28 @@ namespace TRInterface
 
 	void TerminalRendererInterface::blendTile(TInt x, TInt y, const Tile& tile)
 	{
-		AR_ASSERT_MSG(x < drawWidth() && x >= 0 && y < drawHeight() && y >= 0,
+		AR_ASSERT_MSG(x >= 0 && (size_t)x < drawWidth() && y >= 0 && (size_t)y < drawHeight(),
 			"Position ", TermVert(x, y), " is out of bounds. Bounds: ", drawSize());
 
-		m_tiles(y, x).current.blend(tile);
+		Tile blended = Tile::blend(m_current.get(x, y), tile);
+
+		if (!m_current.equals(x, y, blended))
+		{
+			m_current.set(x, y, blended);
+			markDirty(x, y);
+		}
 	}
 
-	TerminalRendererInterface::DrawTile& TerminalRendererInterface::getTile(TInt x, TInt y)
+	TerminalRendererInterface::DrawTile TerminalRendererInterface::viewTile(TInt x, TInt y) const
 	{
-		AR_ASSERT_MSG(x < drawWidth() && x >= 0 && y < drawHeight() && y >= 0,
+		AR_ASSERT_MSG(x >= 0 && (size_t)x < drawWidth() && y >= 0 && (size_t)y < drawHeight(),
 			"Position ", TermVert(x, y), " is out of bounds. Bounds: ", drawSize());
 
-		return m_tiles(y, x);
+		DrawTile tile;
+		tile.current = m_current.get(x, y);
+		tile.last = m_last.get(x, y);
+
+		return tile;
 	}
 
 	void TerminalRendererInterface::setTitle(const std::string& title)
@@ -274,13 +357,25 @@ namespace TRInterface
 		return *m_attr_handler;
 	}
 
+	void TerminalRendererInterface::setColourMode(ColourMode mode, bool dithering)
+	{
+		m_attr_handler->setColourMode(mode, dithering);
+		// tiles drawn with the previous colour mode would otherwise not be updated
+		clearRenderTiles();
+	}
+
+	ColourMode TerminalRendererInterface::getColourMode() const
+	{
+		return m_attr_handler->getColourMode();
+	}
+
 	void TerminalRendererInterface::resize(TermVert size)
 	{
 		AR_ASSERT_MSG(size.x <= AR_IMPL(this).maxSize().x && size.x > 0 && size.y <= AR_IMPL(this).maxSize().y && size.y > 0,
 			"Size ", size, " is too large or negative. Max size: ", AR_IMPL(this).maxSize());
 		
 		// only resize the tiles if the size has actually changed
-		if (!size.isApprox((TermVert)m_tiles.dim()))
+		if (!size.isApprox((TermVert)drawSize()))
 		{
 			m_resize_first = true;
 			m_term_resize = size;
@@ -309,7 +404,7 @@ namespace TRInterface
 		Size2D new_size;
 
 		// ignore if resize is 0, 0, or equal to the current size.
-		if (!m_term_resize.isApprox(Size2D(0, 0)) && (!m_term_resize.isApprox(m_tiles.dim()) || !m_resize_first))
+		if (!m_term_resize.isApprox(Size2D(0, 0)) && (!m_term_resize.isApprox(drawSize()) || !m_resize_first))
 		{
 			new_size = m_term_resize;
 
@@ -319,7 +414,7 @@ namespace TRInterface
 			
 			m_resize_first = false;
 		}
-		else if (size.x != drawWidth() || size.y != drawHeight())
+		else if ((size_t)size.x != drawWidth() || (size_t)size.y != drawHeight())
 		{
 			// terminal size is different from last update
 			new_size = size;
@@ -330,12 +425,17 @@ namespace TRInterface
 		{
 			CT_MEASURE_N("UPDATE SIZE");
 			
-			m_tiles.resize(new_size);
+			m_current.resize(new_size);
+			m_last.resize(new_size, Tile::emptyTile());
+			resizeDirty();
 
+			// the implementation might modify the terminal directly, so the previous frame must be written before this happens.
+			waitForWriter();
 			AR_IMPL(this).resizeBuff();
 
 			// the cursor will have to be rehidden every time the terminal gets resized
-			m_buff_stream << AR_ANSI_CSI << "?25l";
+			pushBuffer(AR_ANSI_CSI);
+			pushBuffer("?25l");
 			// reset stored tiles from last update
 			clearRenderTiles();
 
@@ -354,7 +454,9 @@ namespace TRInterface
 		{
 			CT_MEASURE_N("RENAMING");
 
-			m_attr_handler->setTitle(m_buff_stream, m_title);
+			std::string title_code;
+			m_attr_handler->setTitle(title_code, m_title);
+			pushBuffer(title_code);
 			m_should_rename = false;
 			r_info.new_name = true;
 		}
@@ -369,67 +471,1051 @@ namespace TRInterface
 		return r_info;
 	}
 
+	// returns the colour mode one step below the passed colour mode, Colour16 is the lowest colour mode.
+	static ColourMode reducedColourMode(ColourMode mode)
+	{
+		switch (mode)
+		{
+		case ColourMode::TrueColour:
+			return ColourMode::Colour256;
+		default:
+			return ColourMode::Colour16;
+		}
+	}
+
+	// returns the colour the terminal ends up displaying, when the passed colour is encoded at the given position with the given colour mode.
+	static Colour terminalColour(const Colour& colour, TInt x, TInt y, ColourMode mode, bool dithering)
+	{
+		return ColourLUT::paletteColour(dithering ? ColourLUT::dither(colour, x, y, mode) : colour, mode);
+	}
+
+	// checks if all channels of the passed colours are within the threshold of each other
+	static bool colourClose(const Colour& a, const Colour& b, int threshold)
+	{
+		return std::abs(a.red - b.red) <= threshold && std::abs(a.green - b.green) <= threshold && std::abs(a.blue - b.blue) <= threshold;
+	}
+
 	void TerminalRendererInterface::draw()
 	{
+		// the terminal is not keeping up, so this frame is merged into the next one.
+		// nothing is diffed or encoded, so the dirty tiles and the data pushed by update() are all kept for the next draw() call.
+		if (m_coalesce_frames && isWriting())
+		{
+			m_coalesced_frames++;
+			return;
+		}
 
-		m_print_thrd.joinLoop();
+		std::unique_ptr<CaptureWriter> new_capture;
+		size_t capture_request;
 
-		bool skipped_tile = false;
+		{
+			std::lock_guard<std::mutex> lock(m_capture_mutex);
+			new_capture = std::move(m_pending_capture);
+			capture_request = m_capture_requests;
+		}
+
+		// the terminal state before the capture is not part of the capture, so the entire terminal is redrawn in the first captured frame.
+		if (new_capture)
+		{
+			clearRenderTiles();
+			pushBuffer(AR_ANSI_CSI);
+			pushBuffer("?25l");
+		}
+
+		bool any_dirty = std::any_of(m_dirty_rows.begin(), m_dirty_rows.end(), [](const std::atomic<uint64_t>& word) { return word.load(std::memory_order_relaxed) != 0; });
+
+		if (m_scroll_detection && any_dirty)
+		{
+			CT_MEASURE_N("Scroll detection");
+			scrollTiles();
+		}
+
+		size_t changed_tiles;
+
+		{
+			CT_MEASURE_N("Diff frame");
+			changed_tiles = diffFrame();
+		}
+
+		// the bytes pushed before the tiles (update() and scroll codes) are not part of the tile cost estimate
+		size_t prefix_size = m_arena.size();
+
+		m_frame_quality = applyBudget(changed_tiles);
+		m_frame_colour_mode = m_frame_quality >= QualityLevel::ReducedColour ? reducedColourMode(m_attr_handler->getColourMode()) : m_attr_handler->getColourMode();
+
+		size_t band_count;
 
 		{
 			CT_MEASURE_N("Before Draw loop");
-			m_attr_handler->clear();
 
-			m_attr_handler->move({ 0, 0 });
-			m_attr_handler->moveCode(getStream());
+			// split the frame into bands of rows, one for each thread, as long as each band has enough tiles to make up for the thread overhead.
+			size_t tile_count = drawWidth() * drawHeight();
+			band_count = std::max(tile_count / band_tile_count, (size_t)1);
+			band_count = std::min({ band_count, m_encode_thrds.size() + 1, std::max(drawHeight(), (size_t)1) });
+
+			if (m_bands.size() < band_count)
+				m_bands.resize(band_count);
+
+			size_t band_height = (drawHeight() + band_count - 1) / band_count;
+
+			for (size_t i = 0; i < band_count; i++)
+			{
+				EncodeBand& band = m_bands[i];
+
+				band.begin = (TInt)std::min(i * band_height, drawHeight());
+				band.end = (TInt)std::min((i + 1) * band_height, drawHeight());
+
+				// every band starts from a reset state, as it cannot know what the previous band left the terminal in.
+				band.attr = *m_attr_handler;
+				band.attr.clear();
+				band.attr.setColourMode(m_frame_colour_mode, m_attr_handler->getDithering());
+				band.cursor_known = false;
+				band.encoded_tiles = 0;
+				band.cursor_moves = 0;
+				band.sgr_sequences = 0;
+				band.cursor_bytes = 0;
+				band.colour_bytes = 0;
+				band.glyph_bytes = 0;
+				band.run_sequences = 0;
+			}
 		}
 
 		{
-		CT_MEASURE_N("Draw loop");
+			CT_MEASURE_N("Draw loop");
+
+			m_band_count = band_count;
+			m_next_band = 1;
+
+			for (size_t i = 0; i < band_count - 1; i++)
+				m_encode_thrds[i].startLoop();
+
+			// the first band is encoded on the calling thread, directly after the data pushed in update()
+			encodeBand(m_bands[0], m_arena);
+
+			for (size_t i = 0; i < band_count - 1; i++)
+				m_encode_thrds[i].joinLoop();
+		}
+
+		m_stats = FrameStats();
+		m_stats.changed_tiles = changed_tiles;
+		m_stats.quality = m_frame_quality;
+		m_stats.coalesced_frames = m_coalesced_frames;
+		m_coalesced_frames = 0;
 
-		// this loop needs to access the matrix as row first, then column, even though it is stored as column major,
-		// as the terminal expects the buffer to be ordered as "row major", meaning newlines define where each row begins and ends.
-		for (TInt y = 0; (size_t)y < drawHeight(); y++)
 		{
-			for (TInt x = 0; (size_t)x < drawWidth(); x++)
+			CT_MEASURE_N("Concatenate bands");
+
+			for (size_t i = 1; i < band_count; i++)
+			{
+				m_arena.write(m_bands[i].arena.data(), m_bands[i].arena.size());
+				m_bands[i].arena.clear();
+			}
+
+			for (size_t i = 0; i < band_count; i++)
+			{
+				const EncodeBand& band = m_bands[i];
+
+				m_stats.encoded_tiles += band.encoded_tiles;
+				m_stats.cursor_moves += band.cursor_moves;
+				m_stats.sgr_sequences += band.sgr_sequences;
+				m_stats.cursor_bytes += band.cursor_bytes;
+				m_stats.colour_bytes += band.colour_bytes;
+				m_stats.glyph_bytes += band.glyph_bytes;
+				m_stats.run_sequences += band.run_sequences;
+			}
+		}
+
+		// move the estimate for the chosen level towards the measured cost, so the estimate follows the content being drawn.
+		if (m_stats.encoded_tiles > 0)
+		{
+			double& tile_cost = m_tile_cost[(size_t)m_frame_quality];
+			tile_cost = tile_cost * 0.75 + (double)(m_arena.size() - prefix_size) / m_stats.encoded_tiles * 0.25;
+		}
+
+		{
+			bool is_newline = false;
+			size_t park_start = m_arena.size();
+
+			m_arena.commit(moveCursor(m_bands[band_count - 1], m_arena.reserve(MOVE_MAX_SIZE), (TInt)drawWidth() - 1, (TInt)drawHeight() - 1, is_newline));
+
+			m_stats.cursor_moves += m_arena.size() > park_start;
+			m_stats.cursor_bytes += m_arena.size() - park_start;
+		}
+
+		m_stats.bytes = m_arena.size();
+
+		// the previous frame might still be written to the terminal, only a single frame is allowed to be in flight,
+		// so if the terminal cannot keep up, the draw call blocks here until it has taken the previous frame.
+		{
+			CT_MEASURE_N("Wait for writer");
+
+			DeltaTime wait_start = getTime();
+			m_print_thrd.joinLoop();
+			m_write_blocked_time = getTime() - wait_start;
+		}
+
+		// the writer has finished the previous frame, so this frame is the first one written to the new capture
+		if (new_capture)
+		{
+			std::lock_guard<std::mutex> lock(m_capture_mutex);
+
+			if (capture_request == m_capture_requests)
+				m_capture = std::move(new_capture);
+		}
+
+		m_stats.write_blocked = m_write_blocked_time;
+		m_stats.time = getTime();
+
+		{
+			std::lock_guard<std::mutex> lock(m_telemetry_mutex);
+
+			// the writer has finished the previous frame, so its write time is now known
+			if (m_telemetry_frames > 0)
+				m_telemetry[(m_telemetry_frames - 1) % TELEMETRY_FRAMES].write_time = m_write_time;
+
+			m_stats.frame = m_telemetry_frames;
+			m_telemetry[m_telemetry_frames % TELEMETRY_FRAMES] = m_stats;
+			m_telemetry_frames++;
+		}
+
+		// hand the encoded frame to the writer thread, and encode the next frame into the arena the writer just finished with.
+		std::swap(m_arena, m_flush_arena);
+		m_flush_size = TermVert((TInt)drawWidth(), (TInt)drawHeight());
+		m_writing.store(true, std::memory_order_release);
+		m_print_thrd.startLoop();
+	}
+
+	std::vector<TerminalRendererInterface::FrameStats> TerminalRendererInterface::getTelemetry(size_t first_frame) const
+	{
+		std::lock_guard<std::mutex> lock(m_telemetry_mutex);
+
+		// older frames have been overwritten
+		size_t oldest_frame = m_telemetry_frames > TELEMETRY_FRAMES ? m_telemetry_frames - TELEMETRY_FRAMES : 0;
+		first_frame = std::max(first_frame, oldest_frame);
+
+		std::vector<FrameStats> frames;
+
+		for (size_t frame = first_frame; frame < m_telemetry_frames; frame++)
+			frames.push_back(m_telemetry[frame % TELEMETRY_FRAMES]);
+
+		return frames;
+	}
+
+	bool TerminalRendererInterface::startCapture(const std::filesystem::path& path)
+	{
+		std::unique_ptr<CaptureWriter> capture = std::make_unique<CaptureWriter>(path);
+
+		if (!capture->isOpen())
+		{
+			AR_CORE_ERR("Could not open capture file ", path);
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_capture_mutex);
+		m_capture.reset();
+		m_pending_capture = std::move(capture);
+		m_capture_requests++;
+
+		return true;
+	}
+
+	void TerminalRendererInterface::stopCapture()
+	{
+		std::lock_guard<std::mutex> lock(m_capture_mutex);
+		m_capture.reset();
+		m_pending_capture.reset();
+		m_capture_requests++;
+	}
+
+	bool TerminalRendererInterface::isCapturing() const
+	{
+		std::lock_guard<std::mutex> lock(m_capture_mutex);
+		return m_capture || m_pending_capture;
+	}
+
+	void TerminalRendererInterface::setByteBudget(size_t byte_budget)
+	{
+		m_byte_budget = byte_budget;
+	}
+
+	size_t TerminalRendererInterface::getByteBudget() const
+	{
+		return m_byte_budget;
+	}
+
+	void TerminalRendererInterface::setScrollDetection(bool enabled)
+	{
+		m_scroll_detection = enabled;
+	}
+
+	bool TerminalRendererInterface::getScrollDetection() const
+	{
+		return m_scroll_detection;
+	}
+
+	void TerminalRendererInterface::setRunCompression(bool erase, bool repeat)
+	{
+		m_erase_runs = erase;
+		m_repeat_runs = repeat;
+	}
+
+	bool TerminalRendererInterface::getEraseRuns() const
+	{
+		return m_erase_runs;
+	}
+
+	bool TerminalRendererInterface::getRepeatRuns() const
+	{
+		return m_repeat_runs;
+	}
+
+	void TerminalRendererInterface::setFrameCoalescing(bool enabled)
+	{
+		m_coalesce_frames = enabled;
+	}
+
+	bool TerminalRendererInterface::getFrameCoalescing() const
+	{
+		return m_coalesce_frames;
+	}
+
+	// FNV-1a hash of the attributes of a row of tiles, that are compared in Tile::operator==.
+	// rows containing empty tiles are never equal to any other row, so they are given the hash 0, which is never matched.
+	static uint64_t hashRow(const TilePlanes& planes, TInt y)
+	{
+		constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+		constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+		const uint8_t* flags = planes.flags(y);
+
+		for (size_t x = 0; x < planes.width(); x++)
+			if (flags[x] & TilePlanes::FLAG_EMPTY)
+				return 0;
+
+		uint64_t hash = FNV_OFFSET;
+
+		auto combine = [&](uint32_t value)
+		{
+			for (size_t i = 0; i < sizeof(value); i++)
 			{
-				DrawTile& tile = m_tiles(y, x);
-				Tile& new_tile = tile.current;
-				Tile& old_tile = tile.last;
+				hash ^= (value >> (i * 8)) & 0xFF;
+				hash *= FNV_PRIME;
+			}
+		};
 
-				if (new_tile == old_tile)
+		// each plane is hashed seperately, so the hash runs over contiguous memory.
+		const uint16_t* glyphs = planes.glyphs(y);
+		const Colour* foreground = planes.foreground(y);
+		const Colour* background = planes.background(y);
+
+		for (size_t x = 0; x < planes.width(); x++)
+			combine(glyphs[x]);
+
+		for (size_t x = 0; x < planes.width(); x++)
+			combine(((uint32_t)foreground[x].red << 16) | ((uint32_t)foreground[x].green << 8) | foreground[x].blue);
+
+		for (size_t x = 0; x < planes.width(); x++)
+			combine(((uint32_t)background[x].red << 16) | ((uint32_t)background[x].green << 8) | background[x].blue);
+
+		// 0 is reserved for rows that should never match
+		return hash | 1;
+	}
+
+	void TerminalRendererInterface::scrollTiles()
+	{
+		TInt height = (TInt)drawHeight();
+		size_t width = drawWidth();
+
+		if (height < 2 || width == 0)
+			return;
+
+		m_current_hashes.resize(height);
+		m_last_hashes.resize(height);
+		m_stationary_rows.resize(height + 1);
+
+		m_stationary_rows[0] = 0;
+
+		for (TInt y = 0; y < height; y++)
+		{
+			m_current_hashes[y] = hashRow(m_current, y);
+			m_last_hashes[y] = hashRow(m_last, y);
+
+			// prefix sum of the rows that are already up to date
+			m_stationary_rows[y + 1] = m_stationary_rows[y] + (m_current_hashes[y] != 0 && m_current_hashes[y] == m_last_hashes[y]);
+		}
+
+		// nothing has changed, so there is nothing to scroll
+		if (m_stationary_rows[height] == height)
+			return;
+
+		// find the shift with the longest run of rows, where current row y is equal to last row y + shift.
+		// a positive shift means the content has moved up, a negative shift means it has moved down.
+		TInt best_shift = 0;
+		TInt best_start = 0;
+		TInt best_length = 0;
+		TInt best_gain = 0;
+
+		for (TInt shift = -(height - 1); shift < height; shift++)
+		{
+			if (shift == 0)
+				continue;
+
+			TInt run_start = 0;
+			TInt run_length = 0;
+
+			TInt begin = std::max((TInt)0, (TInt)-shift);
+			TInt end = std::min(height, (TInt)(height - shift));
+
+			for (TInt y = begin; y <= end; y++)
+			{
+				if (y < end && m_current_hashes[y] != 0 && m_current_hashes[y] == m_last_hashes[y + shift])
 				{
-					skipped_tile = true;
+					if (run_length == 0)
+						run_start = y;
+
+					run_length++;
+					continue;
+				}
+
+				if (run_length > 0)
+				{
+					// rows in the scroll region, which are already up to date, would have to be redrawn after the scroll.
+					TInt top = std::min(run_start, (TInt)(run_start + shift));
+					TInt bottom = std::max((TInt)(run_start + run_length - 1), (TInt)(run_start + run_length - 1 + shift));
+
+					TInt gain = run_length - (m_stationary_rows[bottom + 1] - m_stationary_rows[top]);
+
+					if (gain > best_gain)
+					{
+						best_gain = gain;
+						best_shift = shift;
+						best_start = run_start;
+						best_length = run_length;
+					}
+
+					run_length = 0;
+				}
+			}
+		}
+
+		if (best_gain < SCROLL_MIN_ROWS)
+			return;
+
+		TInt top = std::min(best_start, (TInt)(best_start + best_shift));
+		TInt bottom = std::max((TInt)(best_start + best_length - 1), (TInt)(best_start + best_length - 1 + best_shift));
+		TInt distance = std::abs(best_shift);
+
+		// DECSTBM sets the scroll region, CSI n S scrolls the region up and CSI n T scrolls it down.
+		// the scroll region is reset afterwards, both DECSTBM calls move the cursor to the top left corner.
+		char* out = m_arena.reserve(SCROLL_CODE_MAX_SIZE);
+
+		*out++ = '\x1b';
+		*out++ = '[';
+		out = std::to_chars(out, out + 5, top + 1).ptr;
+		*out++ = ';';
+		out = std::to_chars(out, out + 5, bottom + 1).ptr;
+		*out++ = 'r';
+
+		*out++ = '\x1b';
+		*out++ = '[';
+		out = std::to_chars(out, out + 5, distance).ptr;
+		*out++ = best_shift > 0 ? 'S' : 'T';
+
+		*out++ = '\x1b';
+		*out++ = '[';
+		*out++ = 'r';
+
+		m_arena.commit(out);
+
+		// move the last tiles the same way the terminal has moved them, so the diff only contains the newly exposed rows.
+		// the exposed rows are filled with the current background colour of the terminal, which is not known, so they are marked as empty.
+		markRowsDirty(top, bottom + 1);
+
+		if (best_shift > 0)
+		{
+			for (TInt y = top; y <= bottom; y++)
+			{
+				if (y + distance <= bottom)
+					m_last.copyRow(y, m_last, y + distance);
+				else
+					m_last.fillRow(y, Tile::emptyTile());
+			}
+		}
+		else
+		{
+			for (TInt y = bottom; y >= top; y--)
+			{
+				if (y - distance >= top)
+					m_last.copyRow(y, m_last, y - distance);
+				else
+					m_last.fillRow(y, Tile::emptyTile());
+			}
+		}
+	}
+
+	size_t TerminalRendererInterface::diffFrame()
+	{
+		TInt width = (TInt)drawWidth();
+
+		m_mask_words = TileDiff::maskWords(width);
+		m_diff_masks.assign(drawHeight() * m_mask_words, 0);
+
+		size_t changed_tiles = 0;
+
+		for (size_t row_word = 0; row_word < m_dirty_rows.size(); row_word++)
+		{
+			// the dirty rows and spans are reset for the next frame, as they are consumed here.
+			uint64_t rows = m_dirty_rows[row_word].exchange(0, std::memory_order_relaxed);
+
+			while (rows)
+			{
+				TInt y = (TInt)(row_word * DIRTY_WORD_BITS + countTrailingZeros(rows));
+				rows &= rows - 1;
+
+				TInt dirty_begin = m_dirty_begin[y].exchange(width, std::memory_order_relaxed);
+				TInt dirty_end = m_dirty_end[y].exchange(0, std::memory_order_relaxed);
+
+				if (dirty_begin >= dirty_end)
 					continue;
+
+				// compare the entire dirty span at once, the encoder then only has to visit the changed tiles.
+				uint64_t* mask = diffMask(y);
+				TileDiff::diffRow(m_current, m_last, y, dirty_begin, dirty_end, mask);
+
+				for (size_t mask_word = dirty_begin / 64; mask_word <= (size_t)(dirty_end - 1) / 64; mask_word++)
+					changed_tiles += countBits(mask[mask_word]);
+			}
+		}
+
+		return changed_tiles;
+	}
+
+	QualityLevel TerminalRendererInterface::applyBudget(size_t changed_tiles)
+	{
+		if (m_byte_budget == 0 || changed_tiles == 0)
+			return QualityLevel::Full;
+
+		size_t prefix_size = m_arena.size();
+		size_t tile_budget = prefix_size < m_byte_budget ? m_byte_budget - prefix_size : 0;
+
+		// the number of tiles that fit inside the budget at the passed quality level
+		auto maxTiles = [&](QualityLevel quality)
+		{
+			return (size_t)(tile_budget / m_tile_cost[(size_t)quality]);
+		};
+
+		if (changed_tiles <= maxTiles(QualityLevel::Full))
+			return QualityLevel::Full;
+
+		// the remaining budget is spent on some of the similar tiles, otherwise tiles that are only slightly off would never be corrected.
+		size_t tiles = findSimilar(QualityLevel::ColourThreshold);
+		size_t max_tiles = maxTiles(QualityLevel::ColourThreshold);
+
+		tiles += deferTiles(max_tiles > tiles ? max_tiles - tiles : 0);
+
+		if (tiles <= max_tiles)
+			return QualityLevel::ColourThreshold;
+
+		size_t reduced_tiles = findSimilar(QualityLevel::ReducedColour);
+
+		// if most tiles already look the same at the reduced colour depth, the content has settled,
+		// so the frame is better spent on sending every tile that actually changed at full quality,
+		// and refining as many of the remaining similar tiles as the budget allows.
+		if (reduced_tiles * m_tile_cost[(size_t)QualityLevel::ReducedColour] < tile_budget / 2)
+		{
+			deferTiles(max_tiles > reduced_tiles ? max_tiles - reduced_tiles : 0);
+
+			return QualityLevel::ColourThreshold;
+		}
+
+		deferTiles(0);
+
+		if (reduced_tiles <= maxTiles(QualityLevel::ReducedColour))
+			return QualityLevel::ReducedColour;
+
+		interlaceRows();
+
+		return QualityLevel::Interlaced;
+	}
+
+	size_t TerminalRendererInterface::findSimilar(QualityLevel quality)
+	{
+		ColourMode reduced_mode = reducedColourMode(m_attr_handler->getColourMode());
+		bool dithering = m_attr_handler->getDithering();
+		int threshold = budget_colour_threshold;
+
+		size_t tiles = 0;
+		m_similar_tiles.clear();
+
+		for (TInt y = 0; y < (TInt)drawHeight(); y++)
+		{
+			const uint64_t* mask = diffMask(y);
+
+			const uint16_t* glyphs = m_current.glyphs(y);
+			const Colour* foreground = m_current.foreground(y);
+			const Colour* background = m_current.background(y);
+			const uint8_t* flags = m_current.flags(y);
+
+			const uint16_t* last_glyphs = m_last.glyphs(y);
+			const Colour* last_foreground = m_last.foreground(y);
+			const Colour* last_background = m_last.background(y);
+			const uint8_t* last_flags = m_last.flags(y);
+
+			for (size_t mask_word = 0; mask_word < m_mask_words; mask_word++)
+			{
+				uint64_t changed = mask[mask_word];
+
+				while (changed)
+				{
+					TInt x = (TInt)(mask_word * 64 + countTrailingZeros(changed));
+					changed &= changed - 1;
+
+					// only the colours may differ, a different symbol is always sent
+					if (((flags[x] | last_flags[x]) & TilePlanes::FLAG_EMPTY) || glyphs[x] != last_glyphs[x])
+					{
+						tiles++;
+						continue;
+					}
+
+					bool similar = colourClose(foreground[x], last_foreground[x], threshold) && colourClose(background[x], last_background[x], threshold);
+
+					if (!similar && quality >= QualityLevel::ReducedColour)
+						similar = TilePlanes::rgbEqual(terminalColour(foreground[x], x, y, reduced_mode, dithering), last_foreground[x])
+							&& TilePlanes::rgbEqual(terminalColour(background[x], x, y, reduced_mode, dithering), last_background[x]);
+
+					if (similar)
+						m_similar_tiles.emplace_back(x, y);
+					else
+						tiles++;
 				}
+			}
+		}
+
+		return tiles;
+	}
+
+	size_t TerminalRendererInterface::deferTiles(size_t keep)
+	{
+		size_t tile_count = m_similar_tiles.size();
+
+		if (tile_count == 0)
+			return 0;
+
+		// start where the last frame stopped, so every tile is eventually sent.
+		keep = std::min(keep, tile_count);
+		size_t offset = m_similar_offset % tile_count;
+
+		for (size_t i = keep; i < tile_count; i++)
+		{
+			TermVert pos = m_similar_tiles[(offset + i) % tile_count];
+
+			// the tile is sent in a later frame, once the budget allows it
+			diffMask(pos.y)[pos.x / 64] &= ~(1ULL << (pos.x % 64));
+			markDirty(pos.x, pos.y);
+		}
+
+		m_similar_offset = offset + keep;
+
+		return keep;
+	}
+
+	size_t TerminalRendererInterface::interlaceRows()
+	{
+		size_t tiles = 0;
+
+		for (TInt y = 0; y < (TInt)drawHeight(); y++)
+		{
+			if ((y & 1) != m_interlace_field)
+			{
+				deferRow(y);
+				continue;
+			}
+
+			const uint64_t* mask = diffMask(y);
+
+			for (size_t mask_word = 0; mask_word < m_mask_words; mask_word++)
+				tiles += countBits(mask[mask_word]);
+		}
+
+		// the other rows are sent in the next interlaced frame
+		m_interlace_field ^= 1;
+
+		return tiles;
+	}
+
+	void TerminalRendererInterface::deferRow(TInt y)
+	{
+		uint64_t* mask = diffMask(y);
+
+		for (size_t mask_word = 0; mask_word < m_mask_words; mask_word++)
+		{
+			uint64_t changed = mask[mask_word];
+
+			while (changed)
+			{
+				markDirty((TInt)(mask_word * 64 + countTrailingZeros(changed)), y);
+				changed &= changed - 1;
+			}
+
+			mask[mask_word] = 0;
+		}
+	}
+
+	void TerminalRendererInterface::waitForWriter()
+	{
+		m_print_thrd.joinLoop();
+	}
+
+	void TerminalRendererInterface::encodeThrd()
+	{
+		// keep taking bands until there are none left
+		while (true)
+		{
+			size_t band = m_next_band++;
+
+			if (band >= m_band_count)
+				break;
+
+			encodeBand(m_bands[band], m_bands[band].arena);
+		}
+	}
+
+	// returns the number of digits in the decimal representation of the passed value
+	static size_t decimalLength(size_t value)
+	{
+		size_t length = 1;
+
+		while (value >= 10)
+		{
+			value /= 10;
+			length++;
+		}
+
+		return length;
+	}
+
+	// returns the length of the CUF (cursor forward) sequence, moving the cursor the passed distance.
+	// the distance is left out if it is 1, as this is the default value.
+	static size_t forwardLength(size_t distance)
+	{
+		return 2 + (distance > 1 ? decimalLength(distance) : 0) + 1;
+	}
+
+	// writes CSI n <final> to out, n is left out if it is 1, as this is the default value.
+	static char* writeCountSequence(char* out, TInt count, char final)
+	{
+		*out++ = '\x1b';
+		*out++ = '[';
+
+		if (count > 1)
+			out = std::to_chars(out, out + 5, count).ptr;
+
+		*out++ = final;
+
+		return out;
+	}
+
+	// writes the CUF sequence to out
+	static char* writeForward(char* out, TInt distance)
+	{
+		return writeCountSequence(out, distance, 'C');
+	}
+
+	void TerminalRendererInterface::encodeBand(EncodeBand& band, FrameArena& arena)
+	{
+		// the colours are reduced for this frame, so the terminal will not display the current colours.
+		bool reduced = m_frame_colour_mode != m_attr_handler->getColourMode();
+		bool dithering = band.attr.getDithering();
+
+		// this loop needs to access the matrix as row first, then column, even though it is stored as column major,
+		// as the terminal expects the buffer to be ordered as "row major", meaning newlines define where each row begins and ends.
+		for (TInt y = band.begin; y < band.end; y++)
+		{
+			const uint64_t* mask = diffMask(y);
+			// the tiles before this column have already been written by a run sequence
+			TInt run_end = 0;
+
+			// only the changed tiles found in diffFrame() are visited.
+			for (size_t mask_word = 0; mask_word < m_mask_words; mask_word++)
+			{
+				uint64_t changed = mask[mask_word];
 
-				if (skipped_tile)
+				while (changed)
 				{
-					skipped_tile = false;
-					m_attr_handler->move({ x, y });
+					TInt x = (TInt)(mask_word * 64 + countTrailingZeros(changed));
+					changed &= changed - 1;
+
+					if (x < run_end)
+						continue;
+
+					Tile new_tile = m_current.get(x, y);
+
+					// the cursor movement, ansi code and symbol is encoded directly into the arena.
+					char* tile_code = arena.reserve(TILE_CODE_MAX_SIZE);
+					bool is_newline = false;
+
+					char* move_code = tile_code;
+					tile_code = moveCursor(band, tile_code, x, y, is_newline);
+					char* sgr_code = tile_code;
+					// the newline might not always be set, if the tile at position x == 0, is skipped
+					tile_code = band.attr.encodeTile(tile_code, new_tile, { x, y }, is_newline || x == 0);
+
+					arena.commit(tile_code);
+
+					// encodeTile() writes a space in place of the null symbol
+					size_t glyph_length = std::max<size_t>(new_tile.symbol.length(), 1);
+					size_t sgr_length = tile_code - sgr_code - glyph_length;
+
+					band.cursor_moves += sgr_code != move_code;
+					band.cursor_bytes += sgr_code - move_code;
+					band.sgr_sequences += sgr_length > 0;
+					band.colour_bytes += sgr_length;
+					band.glyph_bytes += glyph_length;
+
+					band.cursor.x++;
+					band.encoded_tiles++;
+
+					storeEncodedTile(new_tile, x, y, reduced, dithering);
+
+					if (m_erase_runs || m_repeat_runs)
+						run_end = encodeRun(band, arena, new_tile, x, y);
 				}
+			}
+		}
+	}
+
+	void TerminalRendererInterface::storeEncodedTile(const Tile& tile, TInt x, TInt y, bool reduced, bool dithering)
+	{
+		m_last.copy(x, y, m_current);
+
+		// store the colours the terminal actually displays, and send the tile again at full quality in a later frame.
+		if (reduced)
+		{
+			Colour& last_foreground = m_last.foreground(y)[x];
+			Colour& last_background = m_last.background(y)[x];
+
+			last_foreground = terminalColour(tile.colour, x, y, m_frame_colour_mode, dithering);
+			last_background = terminalColour(tile.background_colour, x, y, m_frame_colour_mode, dithering);
+
+			if (!TilePlanes::rgbEqual(last_foreground, tile.colour) || !TilePlanes::rgbEqual(last_background, tile.background_colour))
+				markDirty(x, y);
+		}
+	}
+
+	TInt TerminalRendererInterface::encodeRun(EncodeBand& band, FrameArena& arena, const Tile& tile, TInt x, TInt y)
+	{
+		TInt width = (TInt)drawWidth();
+
+		// the dithered colours depend on the position, so the tiles of a run would not be displayed with the same colours.
+		if (x + 1 >= width || (band.attr.getDithering() && band.attr.getColourMode() != ColourMode::TrueColour))
+			return x + 1;
+
+		TInt end = x + 1;
+
+		while (end < width && m_current.equals(end, y, tile))
+			end++;
+
+		// the tiles after the last changed tile of the run are already displayed, so they are only written if EL is used.
+		const uint64_t* mask = diffMask(y);
+		TInt last_changed = end - 1;
 
-				m_attr_handler->setForeground(new_tile.colour);
-				m_attr_handler->setBackground(new_tile.background_colour);
-				// the newline might not always be set, if the tile at position x == 0, is skipped
-				m_attr_handler->ansiCode(getStream(), x == 0);
+		while (last_changed > x && !((mask[last_changed / 64] >> (last_changed % 64)) & 1))
+			last_changed--;
 
-				if (!new_tile.eqAttr(old_tile) || new_tile.symbol != old_tile.symbol)
-					m_buff_stream << (const char*)new_tile.symbol;
+		if (last_changed == x)
+			return x + 1;
 
-				old_tile = new_tile;
+		// the bytes needed for writing the changed part of the run tile by tile, ignoring any cursor movement between them.
+		TInt count = last_changed - x;
+		size_t plain_cost = count * std::max<size_t>(tile.symbol.length(), 1);
+
+		// underlined, crossed out or framed spaces are visible, erased tiles are not.
+		// only bold and italic have no effect on a blank tile.
+		bool erase = m_erase_runs && (tile.symbol == ' ' || tile.symbol == '\0');
+
+		for (size_t i = 0; i < ATTR_COUNT && erase; i++)
+			if (i != BOLD && i != ITALIC && band.attr.attributes[i])
+				erase = false;
+
+		enum class Sequence
+		{
+			None,
+			EraseLine,
+			Erase,
+			Repeat
+		};
+
+		Sequence sequence = Sequence::None;
+		size_t cost = plain_cost;
+		size_t count_cost = 2 + (count > 1 ? decimalLength(count) : 0) + 1;
+
+		if (erase && end == width && 3 < cost)
+		{
+			sequence = Sequence::EraseLine;
+			cost = 3;
+		}
+
+		if (m_repeat_runs && count_cost < cost)
+		{
+			sequence = Sequence::Repeat;
+			cost = count_cost;
+		}
+
+		// ECH leaves the cursor after the first tile, so the cost of moving past the run is included.
+		// EL does as well, but the run reaches the end of the row, so the cursor is never moved past it.
+		if (erase && count_cost + forwardLength(count) < cost)
+		{
+			sequence = Sequence::Erase;
+			cost = count_cost + forwardLength(count);
+		}
+
+		if (sequence == Sequence::None)
+			return x + 1;
+
+		char* code = arena.reserve(2 + 5 + 1);
+		char* code_end = code;
+		TInt run_last = last_changed;
+
+		switch (sequence)
+		{
+		case Sequence::EraseLine:
+			code_end = writeCountSequence(code, 1, 'K');
+			run_last = width - 1;
+			break;
+		case Sequence::Erase:
+			code_end = writeCountSequence(code, count, 'X');
+			break;
+		case Sequence::Repeat:
+			code_end = writeCountSequence(code, count, 'b');
+			band.cursor.x = run_last + 1;
+			break;
+		default:
+			break;
+		}
+
+		arena.commit(code_end);
+
+		band.run_sequences++;
+		band.glyph_bytes += code_end - code;
+
+		bool reduced = m_frame_colour_mode != m_attr_handler->getColourMode();
+
+		for (TInt i = x + 1; i <= run_last; i++)
+		{
+			band.encoded_tiles += (mask[i / 64] >> (i % 64)) & 1;
+			storeEncodedTile(tile, i, y, reduced, band.attr.getDithering());
+		}
+
+		return run_last + 1;
+	}
+
+	char* TerminalRendererInterface::moveCursor(EncodeBand& band, char* out, TInt x, TInt y, bool& is_newline)
+	{
+		enum class Motion
+		{
+			None,
+			Absolute,
+			Forward,
+			Rewrite,
+			Newline
+		};
+
+		TInt cursor_x = band.cursor.x;
+		TInt cursor_y = band.cursor.y;
+
+		// a cursor waiting to wrap is still placed in the last column
+		if (band.cursor_known && cursor_y == y && std::min(cursor_x, (TInt)(drawWidth() - 1)) == x)
+			return out;
+
+		Motion motion = Motion::Absolute;
+		// CSI row;col H
+		size_t cost = 2 + decimalLength(y + 1) + 1 + decimalLength(x + 1) + 1;
+
+		if (band.cursor_known && cursor_y == y && cursor_x < x)
+		{
+			size_t forward_cost = forwardLength(x - cursor_x);
+
+			if (forward_cost < cost)
+			{
+				motion = Motion::Forward;
+				cost = forward_cost;
+			}
+
+			// the skipped tiles can only be rewritten if they have the same attributes as the ones currently set in the terminal.
+			size_t rewrite_cost = 0;
+			Colour foreground = band.attr.getForeground();
+			Colour background = band.attr.getBackground();
+
+			const uint16_t* glyphs = m_last.glyphs(y);
+			const Colour* last_foreground = m_last.foreground(y);
+			const Colour* last_background = m_last.background(y);
+			const uint8_t* flags = m_last.flags(y);
+
+			for (TInt i = cursor_x; i < x && rewrite_cost < cost; i++)
+			{
+				if ((flags[i] & TilePlanes::FLAG_EMPTY) || !TilePlanes::rgbEqual(last_foreground[i], foreground) || !TilePlanes::rgbEqual(last_background[i], background) || glyphs[i] == 0)
+				{
+					rewrite_cost = cost;
+					break;
+				}
+
+				rewrite_cost += GlyphTable::length(glyphs[i]);
 			}
 
-			if ((size_t)y < (size_t)drawHeight() - 1 && !skipped_tile)
-				m_buff_stream << '\n';
+			if (rewrite_cost < cost)
+			{
+				motion = Motion::Rewrite;
+				cost = rewrite_cost;
+			}
 		}
+		else if (band.cursor_known && cursor_y < y)
+		{
+			// a newline moves the cursor to the start of the next row, also if the cursor is waiting to wrap.
+			size_t newline_cost = (size_t)(y - cursor_y) + (x > 0 ? forwardLength(x) : 0);
+
+			if (newline_cost < cost)
+			{
+				motion = Motion::Newline;
+				cost = newline_cost;
+			}
 		}
 
-		m_attr_handler->move(TermVert(drawWidth() - 1, drawHeight() - 1));
-		m_attr_handler->moveCode(getStream());
+		switch (motion)
+		{
+		case Motion::Absolute:
+			band.attr.move({ x, y });
+			out = band.attr.moveCode(out);
+			break;
+		case Motion::Forward:
+			out = writeForward(out, x - cursor_x);
+			break;
+		case Motion::Rewrite:
+			for (TInt i = cursor_x; i < x; i++)
+			{
+				uint16_t glyph = m_last.glyphs(y)[i];
+				size_t length = GlyphTable::length(glyph);
+
+				memcpy(out, GlyphTable::data(glyph), length);
+				out += length;
+			}
+			break;
+		case Motion::Newline:
+			memset(out, '\n', y - cursor_y);
+			out += y - cursor_y;
+
+			if (x > 0)
+				out = writeForward(out, x);
+
+			is_newline = true;
+			break;
+		default:
+			break;
+		}
 
-		AR_IMPL(this).flushBuffer();
-		// m_print_thrd.startLoop();
+		band.cursor = TermVert(x, y);
+		band.cursor_known = true;
+
+		return out;
 	}
 	
 	TerminalRendererInterface::TRUpdateInfo TerminalRendererInterface::render()
@@ -448,27 +1534,47 @@ namespace TRInterface
 	Size2D TerminalRendererInterface::drawSize() const
 	{
 		// x is the index for what matrix to acsess so y and z is equivalent to x and y.
-		return m_tiles.dim();
+		return m_current.size();
 	}
 
 	void TerminalRendererInterface::pushBuffer(char c)
 	{
-		AR_IMPL(this).getBuffer()->sputc(c);
+		m_arena.put(c);
 	}
 
 	void TerminalRendererInterface::pushBuffer(const std::string& str)
 	{
-		AR_IMPL(this).getBuffer()->sputn(str.data(), str.size());
+		m_arena.write(str.data(), str.size());
 	}
 
 	void TerminalRendererInterface::pushBuffer(const char* c_str)
 	{
-		AR_IMPL(this).getBuffer()->sputn(c_str, strlen(c_str));
+		m_arena.write(c_str, strlen(c_str));
 	}
 
 	void TerminalRendererInterface::pushBuffer(const char* c_buff, size_t buff_len)
 	{
-		AR_IMPL(this).getBuffer()->sputn(c_buff, buff_len);
+		m_arena.write(c_buff, buff_len);
+	}
+
+	void TerminalRendererInterface::flushFrame()
+	{
+		CT_MEASURE_N("Write frame");
+
+		DeltaTime write_start = getTime();
+		AR_IMPL(this).flushBuffer(m_flush_arena.data(), m_flush_arena.size());
+		m_write_time = getTime() - write_start;
+
+		{
+			std::lock_guard<std::mutex> lock(m_capture_mutex);
+
+			if (m_capture)
+				m_capture->write(write_start, m_flush_size.x, m_flush_size.y, m_flush_arena.data(), m_flush_arena.size());
+		}
+
+		m_flush_arena.clear();
+
+		m_writing.store(false, std::memory_order_release);
 	}
 
 	std::array<bool, ATTR_COUNT>& TerminalRendererInterface::attributes()
@@ -478,9 +1584,67 @@ namespace TRInterface
 	
 } // TRInterface
 
+	void TilePlanes::resize(Size2D size, const Tile& fill_tile)
+	{
+		// pad the rows, so each row starts at an aligned address in every plane.
+		// the flags plane has the smallest elements, so the padding is based on this.
+		constexpr size_t row_alignment = ALIGNMENT / sizeof(uint8_t);
+		size_t stride = (size.x + row_alignment - 1) / row_alignment * row_alignment;
+
+		TilePlanes resized;
+		resized.m_width = size.x;
+		resized.m_height = size.y;
+		resized.m_stride = stride;
+
+		resized.m_glyphs = allocatePlane<uint16_t>(stride * size.y);
+		resized.m_foreground = allocatePlane<Colour>(stride * size.y);
+		resized.m_background = allocatePlane<Colour>(stride * size.y);
+		resized.m_flags = allocatePlane<uint8_t>(stride * size.y);
+
+		resized.fill(fill_tile);
+
+		// preserve the tiles inside both sizes
+		size_t copy_width = std::min(m_width, resized.m_width);
+		size_t copy_height = std::min(m_height, resized.m_height);
+
+		for (size_t y = 0; y < copy_height; y++)
+		{
+			memcpy(resized.glyphs((TInt)y), glyphs((TInt)y), copy_width * sizeof(uint16_t));
+			memcpy((void*)resized.foreground((TInt)y), foreground((TInt)y), copy_width * sizeof(Colour));
+			memcpy((void*)resized.background((TInt)y), background((TInt)y), copy_width * sizeof(Colour));
+			memcpy(resized.flags((TInt)y), flags((TInt)y), copy_width * sizeof(uint8_t));
+		}
+
+		*this = std::move(resized);
+	}
+
+	void TilePlanes::fill(const Tile& tile)
+	{
+		for (size_t y = 0; y < m_height; y++)
+			fillRow((TInt)y, tile);
+	}
+
+	void TilePlanes::fillRow(TInt y, const Tile& tile)
+	{
+		std::fill_n(glyphs(y), m_width, tile.symbol.id());
+		std::fill_n(foreground(y), m_width, tile.colour);
+		std::fill_n(background(y), m_width, tile.background_colour);
+		std::fill_n(flags(y), m_width, tile.is_empty ? FLAG_EMPTY : 0);
+	}
+
+	void TilePlanes::copyRow(TInt dst_y, const TilePlanes& other, TInt src_y)
+	{
+		AR_ASSERT_MSG(other.m_width == m_width, "Cannot copy rows between planes of different widths");
+
+		memmove(glyphs(dst_y), other.glyphs(src_y), m_width * sizeof(uint16_t));
+		memmove((void*)foreground(dst_y), other.foreground(src_y), m_width * sizeof(Colour));
+		memmove((void*)background(dst_y), other.background(src_y), m_width * sizeof(Colour));
+		memmove(flags(dst_y), other.flags(src_y), m_width * sizeof(uint8_t));
+	}
+
 	std::ostream& operator<<(std::ostream& stream, const Tile& tile)
 	{
-		stream << (int)tile.symbol << " (" << tile.background_colour << ") (" << tile.colour << ") ";
+		stream << (const char*)tile.symbol << " (" << tile.background_colour << ") (" << tile.colour << ") ";
 		return stream;
 	}
 
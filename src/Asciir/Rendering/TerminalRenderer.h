@@ -1,10 +1,14 @@
-#pragma once
+﻿#pragma once
 
 #include "AsciiAttributes.h"
 #include "RenderConsts.h"
+#include "FrameArena.h"
+#include "FrameCapture.h"
+#include "Glyph.h"
 #include "Asciir/Maths/Vertices.h"
 #include "Asciir/Maths/Matrix.h"
 #include "Asciir/Maths/Tensor.h"
+#include "Asciir/Core/Timing.h"
 
 namespace Asciir
 {
@@ -17,6 +21,21 @@ namespace Asciir
 		Filled
 	};
 
+	/// @brief the quality level a frame was encoded at, when a byte budget is set.
+	/// each level includes the reductions of the levels before it.
+	/// @see TerminalRendererInterface::setByteBudget()
+	enum class QualityLevel
+	{
+		/// @brief every changed tile is sent, using the selected colour mode.
+		Full,
+		/// @brief tiles with the same symbol, whose colours are within TerminalRendererInterface::budget_colour_threshold of the terminal colours, are not sent.
+		ColourThreshold,
+		/// @brief the colours are sent with a lower colour depth (true colour becomes 256 colours, 256 colours becomes 16 colours).
+		ReducedColour,
+		/// @brief only every other row is sent, alternating between the even and odd rows each frame.
+		Interlaced
+	};
+
 	/// @brief checks the size of a single UTF-8 character
 	size_t U8CharSize(const char* u8_str);
 	/// @brief calculates the UTF-8 character count from the given string
@@ -93,12 +112,12 @@ namespace Asciir
 
 	struct Tile
 	{
-		UTF8Char symbol = ' ';
+		Glyph symbol = ' ';
 		Colour colour = WHITE8;
 		Colour background_colour = BLACK8;
 		bool is_empty = true;
 
-		Tile(Colour background_colour = BLACK8, Colour colour = WHITE8, UTF8Char symbol = ' ', bool is_empty = false)
+		Tile(Colour background_colour = BLACK8, Colour colour = WHITE8, Glyph symbol = ' ', bool is_empty = false)
 			: symbol(symbol), colour(colour), background_colour(background_colour), is_empty(is_empty) {}
 
 		static inline Tile emptyTile()
@@ -157,24 +176,158 @@ namespace Asciir
 
 	std::ostream& operator<<(std::ostream& stream, const Tile& tile);
 
+	// ============ TilePlanes ============
+
+	/// @brief stores a frame of tiles as seperate planes, one for each attribute of a tile.
+	/// 
+	/// the planes are the glyphs, the foreground colours, the background colours and the flags of the tiles.
+	/// each plane is a seperate aligned block of memory, where every row starts at a multiple of ALIGNMENT bytes.
+	/// this way, passes over the frame, like comparing or clearing it, run over contiguous memory, without any padding between the tiles.
+	/// 
+	/// the glyphs are stored as their id in the GlyphTable, @see Glyph::id().
+	class TilePlanes
+	{
+	public:
+		/// @brief the alignment, in bytes, of every row in each plane.
+		static constexpr size_t ALIGNMENT = 64;
+
+		/// @brief set if the tile is empty, @see Tile::is_empty
+		static constexpr uint8_t FLAG_EMPTY = 1 << 0;
+
+		TilePlanes() = default;
+
+		/// @brief resizes the planes, the tiles inside both the old and new size are preserved, and the rest are set to fill_tile.
+		void resize(Size2D size, const Tile& fill_tile = Tile());
+		/// @brief sets every tile to the passed tile.
+		void fill(const Tile& tile);
+		/// @brief sets every tile in the passed row to the passed tile.
+		void fillRow(TInt y, const Tile& tile);
+		/// @brief copies the passed row of other into the passed row of this.
+		void copyRow(TInt dst_y, const TilePlanes& other, TInt src_y);
+
+		size_t width() const { return m_width; }
+		size_t height() const { return m_height; }
+		Size2D size() const { return Size2D(m_width, m_height); }
+		/// @brief the number of elements between the start of each row in a plane.
+		size_t stride() const { return m_stride; }
+
+		/// @brief pointers to the start of the passed row in each plane.
+		uint16_t* glyphs(TInt y) { return m_glyphs.get() + y * m_stride; }
+		const uint16_t* glyphs(TInt y) const { return m_glyphs.get() + y * m_stride; }
+		Colour* foreground(TInt y) { return m_foreground.get() + y * m_stride; }
+		const Colour* foreground(TInt y) const { return m_foreground.get() + y * m_stride; }
+		Colour* background(TInt y) { return m_background.get() + y * m_stride; }
+		const Colour* background(TInt y) const { return m_background.get() + y * m_stride; }
+		uint8_t* flags(TInt y) { return m_flags.get() + y * m_stride; }
+		const uint8_t* flags(TInt y) const { return m_flags.get() + y * m_stride; }
+
+		/// @brief returns the tile at the passed position.
+		Tile get(TInt x, TInt y) const
+		{
+			size_t i = index(x, y);
+
+			Tile tile(m_background[i], m_foreground[i], Glyph::fromId(m_glyphs[i]), m_flags[i] & FLAG_EMPTY);
+
+			return tile;
+		}
+
+		/// @brief sets the tile at the passed position.
+		void set(TInt x, TInt y, const Tile& tile)
+		{
+			size_t i = index(x, y);
+
+			m_glyphs[i] = tile.symbol.id();
+			m_foreground[i] = tile.colour;
+			m_background[i] = tile.background_colour;
+			m_flags[i] = tile.is_empty ? FLAG_EMPTY : 0;
+		}
+
+		/// @brief copies the tile at the passed position from other.
+		void copy(TInt x, TInt y, const TilePlanes& other)
+		{
+			size_t i = index(x, y);
+			size_t j = other.index(x, y);
+
+			m_glyphs[i] = other.m_glyphs[j];
+			m_foreground[i] = other.m_foreground[j];
+			m_background[i] = other.m_background[j];
+			m_flags[i] = other.m_flags[j];
+		}
+
+		/// @brief same as Tile::operator==(), for the tile at the passed position.
+		bool equals(TInt x, TInt y, const Tile& tile) const
+		{
+			size_t i = index(x, y);
+
+			return !(m_flags[i] & FLAG_EMPTY) && !tile.is_empty && m_glyphs[i] == tile.symbol.id()
+				&& rgbEqual(m_foreground[i], tile.colour) && rgbEqual(m_background[i], tile.background_colour);
+		}
+
+		/// @brief same as Tile::operator==(), for the tiles at the passed position in this and other.
+		bool equals(TInt x, TInt y, const TilePlanes& other) const
+		{
+			size_t i = index(x, y);
+			size_t j = other.index(x, y);
+
+			return !((m_flags[i] | other.m_flags[j]) & FLAG_EMPTY) && m_glyphs[i] == other.m_glyphs[j]
+				&& rgbEqual(m_foreground[i], other.m_foreground[j]) && rgbEqual(m_background[i], other.m_background[j]);
+		}
+
+
+		/// @brief compares the colours, ignoring the alpha channel, same as Colour::operator==().
+		static bool rgbEqual(const Colour& a, const Colour& b)
+		{
+			return a.red == b.red && a.green == b.green && a.blue == b.blue;
+		}
+
+	protected:
+		size_t index(TInt x, TInt y) const
+		{
+			AR_ASSERT_MSG((size_t)x < m_width && x >= 0 && (size_t)y < m_height && y >= 0,
+				"Position ", TermVert(x, y), " is out of bounds. Bounds: ", size());
+
+			return (size_t)y * m_stride + (size_t)x;
+		}
+
+		struct AlignedDelete
+		{
+			void operator()(void* ptr) const { ::operator delete(ptr, std::align_val_t(ALIGNMENT)); }
+		};
+
+		template<typename T>
+		using Plane = std::unique_ptr<T[], AlignedDelete>;
+
+		template<typename T>
+		static Plane<T> allocatePlane(size_t count)
+		{
+			return Plane<T>((T*)::operator new(count * sizeof(T), std::align_val_t(ALIGNMENT)));
+		}
+
+		size_t m_width = 0;
+		size_t m_height = 0;
+		size_t m_stride = 0;
+
+		Plane<uint16_t> m_glyphs;
+		Plane<Colour> m_foreground;
+		Plane<Colour> m_background;
+		Plane<uint8_t> m_flags;
+	};
+
 	// ==================== TerminalRenderer ====================
 
 	namespace TRInterface
 	{
 
-		/// @brief console output buffer for the TerminalRenderer pushBuffer functions.  
+		/// @brief console output for the TerminalRenderer.  
 		/// 
 		/// should only be used by the TerminalRenderer and nothing else.  
-		/// implementation is latform specific
+		/// implementation is platform specific
 		/// 
 		/// implementation details:
 		/// 
-		/// whenever xsputn is called, the buffer checks if there is enough space for the passed value.
-		/// if there is, put it into the buffer.
-		/// if there is not, flush the buffer and put the input data into the buffer.
-		/// if the input data is larger than the buffer itself, flush the buffer and the data.
-		/// 
-		/// when the buffer is flushed, the buffer is simply printed out to the terminal.
+		/// the TerminalRenderer encodes an entire frame into its FrameArena,
+		/// which is then passed to the buffer as a single span, when the frame is flushed.
+		/// the buffer is responsible for writing this span to the terminal, as efficiently as the platform allows.
 		/// 
 		class TermRendererBuffer;
 
@@ -196,7 +349,7 @@ namespace Asciir
 		/// 
 		/// setState() determins the current value that will be put at the Tile, when calling drawTile() or blendTile().
 		/// 
-		/// in order to view a tile at a specific position, use getTile().
+		/// in order to view a tile at a specific position, use getTile(), or viewTile() to also view the previously rendered tile.
 		/// 
 		/// to output the rendered data to the terminal, use render().
 		/// 
@@ -226,10 +379,30 @@ namespace Asciir
 				std::string title;
 				/// @brief the size of the terminal
 				TermVert size;
-				/// @brief the buffer size of the TerminalRenderer
+				/// @brief the initial size of the frame buffer of the TerminalRenderer.
+				/// the buffer grows if a frame does not fit inside it, so this only needs to be large enough for a typical frame.
 				size_t buffer_size;
-
-				TerminalProps(const std::string& title = "Asciir App", TermVert size = { 0, 0 }, size_t buffer_size = 1024ULL * 1024ULL * 128ULL)
+				/// @brief the colour depth of the colour codes sent to the terminal
+				ColourMode colour_mode = ColourMode::TrueColour;
+				/// @brief wether the colours should be dithered, when a colour mode other than ColourMode::TrueColour is used
+				bool dithering = false;
+				/// @brief the maximum number of bytes a single frame should take up, 0 means no limit.
+				/// @see setByteBudget()
+				size_t byte_budget = 0;
+				/// @brief wether the terminal supports erasing tiles with ECH and EL, using the current background colour.
+				/// @see setRunCompression()
+				bool erase_runs = false;
+				/// @brief wether the terminal supports repeating the last symbol with REP.
+				/// @see setRunCompression()
+				bool repeat_runs = false;
+				/// @brief wether frames drawn whilst the terminal is still receiving the previous frame are merged into the next frame.
+				/// @see setFrameCoalescing()
+				bool coalesce_frames = false;
+				/// @brief wether draw() should look for vertically scrolled regions.
+				/// @see setScrollDetection()
+				bool scroll_detection = false;
+
+				TerminalProps(const std::string& title = "Asciir App", TermVert size = { 0, 0 }, size_t buffer_size = 1024ULL * 64ULL)
 					: title(title), size(size), buffer_size(buffer_size)
 				{}
 			};
@@ -243,7 +416,47 @@ namespace Asciir
 				bool new_zoom = false; // TODO: implement this
 			};
 
-			/// @brief structure containing two tiles, the current tile, and the previously rendered tile
+			/// @brief statistics of a single drawn frame
+			struct FrameStats
+			{
+				/// @brief the number of the frame, counting from the first draw() call
+				size_t frame = 0;
+				/// @brief the time the frame was handed to the writer thread, @see getTime()
+				DeltaTime time;
+				/// @brief the size of the encoded frame in bytes
+				size_t bytes = 0;
+				/// @brief the number of tiles that differed from the terminal
+				size_t changed_tiles = 0;
+				/// @brief the number of tiles actually sent to the terminal
+				size_t encoded_tiles = 0;
+				/// @brief the quality level the frame was encoded at
+				QualityLevel quality = QualityLevel::Full;
+				/// @brief the number of draw() calls merged into this frame, as the terminal had not finished receiving the previous frame.
+				/// @see setFrameCoalescing()
+				size_t coalesced_frames = 0;
+
+				/// @brief the number of cursor movements emitted between tiles
+				size_t cursor_moves = 0;
+				/// @brief the number of SGR (colour and attribute) sequences emitted
+				size_t sgr_sequences = 0;
+				/// @brief bytes spent on moving the cursor
+				size_t cursor_bytes = 0;
+				/// @brief bytes spent on SGR sequences
+				size_t colour_bytes = 0;
+				/// @brief bytes spent on the symbols of the tiles, including the erase and repeat sequences
+				size_t glyph_bytes = 0;
+				/// @brief the number of erase and repeat sequences emitted for runs of identical tiles
+				size_t run_sequences = 0;
+
+				/// @brief the time draw() was blocked, waiting for the previous frame to be written
+				DeltaTime write_blocked;
+				/// @brief the time the platform write of this frame took.
+				/// @note this is only known once the writer thread has finished, so it is filled in by the next draw() call.
+				DeltaTime write_time;
+			};
+
+			/// @brief structure containing two tiles, the current tile, and the previously rendered tile.
+			/// the tiles are not stored as DrawTiles, this is only used for viewing a single position, @see viewTile().
 			struct DrawTile
 			{
 				Tile current;
@@ -292,10 +505,14 @@ namespace Asciir
 			/// @brief blends the tile at pos with the specified tile. does not modify the current tile state.
 			void blendTile(TInt x, TInt y, const Tile& tile);
 			void blendTile(const TermVert& pos, const Tile& tile) { blendTile(pos.x, pos.y, tile); }
-			/// @brief retrieve the DrawTile at the passed position
-			/// @return the current and previosly rendered tile at the specified position
-			DrawTile& getTile(TInt x, TInt y);
-			DrawTile& getTile(const TermVert& pos) { return getTile(pos.x, pos.y); }
+			/// @brief retrieve the current and previously rendered tile at the passed position.
+			/// @note the tiles are returned by value, use drawTile() to modify the current tile.
+			DrawTile viewTile(TInt x, TInt y) const;
+			DrawTile viewTile(const TermVert& pos) const { return viewTile(pos.x, pos.y); }
+			/// @brief retrieve the current tile at the passed position, same as viewTile().current
+			/// @note the tile is returned by value, use drawTile() to modify it.
+			Tile getTile(TInt x, TInt y) const { return viewTile(x, y).current; }
+			Tile getTile(const TermVert& pos) const { return getTile(pos.x, pos.y); }
 			/// @brief set the title of the terminal
 			/// @note the title will only be changed on the terminal once it has been rendered
 			void setTitle(const std::string& title);
@@ -306,16 +523,118 @@ namespace Asciir
 			/// @brief get the AsciiAttr instance for the current terminal
 			const AsciiAttr& getAttrHandler();
 
+			/// @brief sets the colour depth of the colour codes sent to the terminal.
+			/// lower colour depths result in shorter ansi codes, at the cost of colour precision.
+			/// @note this forces the entire terminal to be redrawn on the next draw() call.
+			/// @param dithering wether to use ordered dithering, in order to make up for the lost colour precision.
+			void setColourMode(ColourMode mode, bool dithering = false);
+			/// @brief returns the currently used colour mode
+			ColourMode getColourMode() const;
+
 
 			/// @brief updates the terminal properties.  
 			/// this function updates the size, title, and fontsize (TODO: implement font size)
 			/// @return returns a TRUpdateInfo structure containing information about the changes from the previous terminal properties to the current terminal properties.
 			TRUpdateInfo update();
 			/// @brief draws the currently stored frame into the terminal, and stores this frame as the previous frame.
+			/// 
+			/// if encode threads have been set, the frame is split into bands of rows, which are encoded in parallel, and then concatenated in order.
+			/// @see setEncodeThreads()
+			/// 
+			/// the encoded frame is written to the terminal on a seperate writer thread, so the next frame can be rendered whilst the terminal receives the current one.
+			/// only one frame can be in flight at a time, so if the previous frame has not been written yet, this call blocks until it has,
+			/// unless frame coalescing is enabled, in which case the frame is merged into the next one instead, @see setFrameCoalescing().
+			/// @see getWriteBlockedTime()
+			/// @note with frame coalescing enabled, this may skip the frame and return without sending anything to the terminal,
+			/// the skipped changes are only sent by a later draw() call.
 			void draw();
+			/// @brief blocks until the writer thread has finished writing the last drawn frame to the terminal.
+			void waitForWriter();
+
+			/// @brief sets the maximum number of bytes a single frame should take up, 0 means no limit.
+			/// 
+			/// if a frame is estimated to exceed the budget, draw() progressively lowers the quality of the frame, @see QualityLevel.
+			/// the tiles left out of a frame are sent in the following frames, once the budget allows it.
+			/// 
+			/// this is useful for holding a target frame rate on a slow connection (ssh), the budget should be link speed / frame rate.
+			/// @note the budget is not a hard limit, if even the lowest quality level exceeds it, the frame is still sent.
+			void setByteBudget(size_t byte_budget);
+			/// @brief returns the current byte budget, 0 means no limit.
+			size_t getByteBudget() const;
+
+			/// @brief tiles with the same symbol, whose colour channels all differ less than this value from the terminal colours,
+			/// are not sent at QualityLevel::ColourThreshold or lower.
+			static inline uint8_t budget_colour_threshold = 24;
+
+			/// @brief returns the statistics of the last drawn frame.
+			/// @note should only be called from the thread calling draw(), use getTelemetry() from any other thread.
+			const FrameStats& getFrameStats() const { return m_stats; }
+
+			/// @brief the number of frames kept in the telemetry ring buffer
+			static constexpr size_t TELEMETRY_FRAMES = 256;
+
+			/// @brief returns the statistics of the frames still in the telemetry ring buffer, starting at the passed frame number, oldest frame first.
+			/// 
+			/// this can be polled with first_frame = last returned frame + 1, to receive every frame exactly once,
+			/// as long as no more than TELEMETRY_FRAMES frames are drawn in between.
+			/// @note this is safe to call from any thread.
+			std::vector<FrameStats> getTelemetry(size_t first_frame = 0) const;
+
+			/// @brief enables or disables scroll detection in draw().
+			/// 
+			/// if enabled, draw() looks for parts of the frame that have moved vertically since the last frame, and scrolls the terminal instead,
+			/// so only the newly exposed rows have to be redrawn.
+			/// 
+			/// the detection hashes every row of the current and last frame and tests every possible shift, on every frame with changes.
+			/// this only pays off for content that actually scrolls, so it is disabled by default.
+			/// @see scrollTiles()
+			void setScrollDetection(bool enabled);
+			/// @brief returns wether scroll detection is enabled.
+			bool getScrollDetection() const;
+
+			/// @brief sets which control sequences draw() may use for runs of identical tiles.
+			/// 
+			/// runs of spaces are erased with ECH (CSI n X), or EL (CSI K) if the run reaches the end of the row,
+			/// any other run is written as its first symbol, followed by REP (CSI n b).
+			/// a run is only compressed if the sequence takes up fewer bytes than writing the tiles.
+			/// 
+			/// @param erase the terminal fills erased tiles with the current background colour (bce).
+			/// many terminals do, but some multiplexer configurations and windows hosts clear to the default background instead, so this is disabled by default.
+			/// runs with attributes that are visible on a blank tile, e.g. underline or framed, are never erased.
+			/// @param repeat the terminal supports REP, which some terminals do not, e.g. the linux console. disabled by default.
+			void setRunCompression(bool erase, bool repeat);
+			/// @brief returns wether runs of spaces may be erased with ECH and EL.
+			bool getEraseRuns() const;
+			/// @brief returns wether runs of symbols may be written with REP.
+			bool getRepeatRuns() const;
+
+			/// @brief enables or disables frame coalescing in draw().
+			/// 
+			/// if enabled, and the terminal has not finished receiving the previous frame when draw() is called, the frame is not encoded, and draw() returns immediately.
+			/// the changes of the skipped frames are kept, so the next draw() call after the terminal has caught up, sends a single frame
+			/// containing the difference between the last sent frame and the newest frame.
+			/// 
+			/// this way, a terminal or connection slower than the frame rate only receives the newest state, and the time from drawing a frame, until it is displayed, stays bounded.
+			/// @note the coalesced changes are only sent on the next draw() call, so draw() should keep being called, even if nothing has changed.
+			/// disabled by default.
+			void setFrameCoalescing(bool enabled);
+			/// @brief returns wether frame coalescing is enabled.
+			bool getFrameCoalescing() const;
+			/// @brief returns wether the writer thread is still writing the last drawn frame to the terminal.
+			bool isWriting() const { return m_writing.load(std::memory_order_acquire); }
 			/// @brief calls update() and draw().
 			TRUpdateInfo render();
 			
+			/// @brief sets the number of threads, besides the calling thread, used for encoding the frame in draw().
+			/// @note as with Renderer::setThreads(), all threads are reallocated and restarted, so this should be called as little as possible.
+			void setEncodeThreads(uint32_t thread_count);
+			/// @brief returns the number of threads used for encoding the frame, besides the calling thread.
+			uint32_t getEncodeThreads() const { return (uint32_t)m_encode_thrds.size(); }
+
+			/// @brief the minimum number of tiles a band of rows should contain, before it is encoded on a seperate thread.
+			/// smaller frames are encoded on fewer threads, as the thread overhead would outweigh the time spent encoding.
+			static inline size_t band_tile_count = 8192;
+
 			/// @brief request the terminal to resize to the specified size
 			/// the terminal will actually resize only once update() has been called.
 			void resize(TermVert size);
@@ -330,8 +649,8 @@ namespace Asciir
 			AR_INT_FUNC_R((TermVert) termSize() const, ({}))
 			/// @brief get the size where the TerminalRenderer is able to draw.
 			Size2D drawSize() const;
-			size_t drawWidth() const { return m_tiles.width(); }
-			size_t drawHeight() const { return m_tiles.height(); }
+			size_t drawWidth() const { return m_current.width(); }
+			size_t drawHeight() const { return m_current.height(); }
 			/// @brief returns the maximum possible size of the terminal. (-1, -1) = no limit.
 			AR_INT_FUNC_R((TermVert) maxSize() const, ({}))
 
@@ -348,29 +667,43 @@ namespace Asciir
 			/// @param the name of the font.
 			/// @param new_size the font size.
 			/// @return wether the function was successfull in setting the font. this will fail if the font_name is invalid (does not exist), or the size is invalid.
-			// ignore unused variable warning
-			#pragma warning(push)
-			#pragma warning(suppress: 4100)
-			AR_INT_FUNC_R((bool) setFont(const std::string& font_name, Size2D new_size), ({}))
-			#pragma warning(pop)
+			AR_INT_FUNC_R((bool) setFont(const std::string& /*font_name*/, Size2D /*new_size*/), ({}))
 
 			/// @brief resturns wether the terminal window is currently focused
 			AR_INT_FUNC_R((bool) isFocused() const, ({}))
 
-			/// TODO: should these still be here? 
+			/// @brief appends the passed data to the current frame.
 			void pushBuffer(const std::string& data);
 			void pushBuffer(const char* c_str);
 			void pushBuffer(const char* c_buff, size_t buff_len);
 			void pushBuffer(char c);
 
-			/// @brief is called when the draw function finishes and the buffer should display its contents to the console.
-			AR_INT_FUNC_R((void) flushBuffer(),());
-
-			/// @brief get the current buffer of the TerminalRenderer buffer.
-			// this should return the platform implementation of the TermRendererBuffer.
-			AR_INT_FUNC_R((std::streambuf*) getBuffer(), (nullptr))
-			/// @brief get the ostream for the TerminalRenderer buffer
-			std::ostream& getStream(){ return m_buff_stream; }
+			/// @brief is called when the draw function finishes and the encoded frame should be displayed in the console.
+			/// @param data the encoded frame, only valid for the duration of the call.
+			/// @param size the size of the encoded frame in bytes.
+			AR_INT_FUNC_R((void) flushBuffer(const char*, size_t),());
+
+			/// @brief get the arena containing the encoded data of the current frame.
+			const FrameArena& getArena() const { return m_arena; }
+
+			/// @brief returns the time the last draw() call spent waiting for the writer thread to finish writing the previous frame.
+			/// a consistently non zero value means the terminal is not able to keep up with the frame rate.
+			DeltaTime getWriteBlockedTime() const { return m_write_blocked_time; }
+			/// @brief returns the time it took the writer thread to write the last finished frame.
+			/// @note this value is written by the writer thread, so it should only be read after waitForWriter() or draw() has been called.
+			DeltaTime getWriteTime() const { return m_write_time; }
+
+			/// @brief starts capturing the frames written to the terminal, along with the time they were written, to the passed capture file.
+			/// any current capture is stopped first. @see CaptureWriter
+			/// 
+			/// the capture can be replayed without the application, using the ARReplay tool,
+			/// which is useful for measuring the throughput of a terminal, or comparing changes to the encoder on a real session.
+			/// @return false if the capture file could not be opened.
+			bool startCapture(const std::filesystem::path& path);
+			/// @brief stops the current capture, and closes the capture file.
+			void stopCapture();
+			/// @brief returns wether the frames are currently being captured.
+			bool isCapturing() const;
 
 			/// @brief return array of attributes for the current state.
 			std::array<bool, ATTR_COUNT>& attributes();
@@ -384,8 +717,111 @@ namespace Asciir
 			/// as this function makes use of the ansi resize and rename escape sequance
 			void initRenderer(const TerminalProps& term_props);
 
+			/// @brief passes the frame handed to the writer thread to the implementation, and resets its arena for the frame after the next.
+			/// this is run by the writer thread.
+			void flushFrame();
+
+			/// @brief the minimum number of rows a scroll has to save from being redrawn, before the terminal is scrolled.
+			static constexpr TInt SCROLL_MIN_ROWS = 2;
+			/// @brief the maximum length, in bytes, of the scroll sequence written by scrollTiles().
+			// 2 + 5 + 1 + 5 + 1 bytes for the DECSTBM sequence, 2 + 5 + 1 for the scroll and 3 for the DECSTBM reset.
+			static constexpr size_t SCROLL_CODE_MAX_SIZE = 14 + 8 + 3;
+
+			/// @brief marks the tile at the passed position as changed since the last draw() call.
+			/// 
+			/// each row keeps track of a span of dirty columns, and a bitmap keeps track of the rows with a non empty span.
+			/// draw() only compares the tiles inside the dirty spans of the dirty rows, so any modification of the current or last tiles must mark the tile as dirty.
+			/// this is thread safe, so tiles can be drawn from multiple threads.
+			void markDirty(TInt x, TInt y);
+			/// @brief marks the entire rows in the range [begin, end) as dirty.
+			void markRowsDirty(TInt begin, TInt end);
+			/// @brief reallocates the dirty rows to fit the current draw size, marking all rows as dirty.
+			void resizeDirty();
+
+			/// @brief detects if a part of the frame has moved vertically since the last frame, using a hash of each row in the current and last frame.
+			/// 
+			/// if a shift saves enough rows from being redrawn, the terminal is scrolled using a scroll region (DECSTBM) and CSI n S / CSI n T,
+			/// and the last tiles are moved accordingly, so only the newly exposed rows are encoded afterwards.
+			void scrollTiles();
+
+			/// @brief compares the dirty spans of the current and last tiles, storing the changed tiles in the diff masks.
+			/// this consumes the dirty spans and rows.
+			/// @return the number of changed tiles.
+			size_t diffFrame();
+			/// @brief returns the diff mask of the passed row, @see TileDiff
+			uint64_t* diffMask(TInt y) { return m_diff_masks.data() + y * m_mask_words; }
+
+			/// @brief lowers the quality level until the frame is estimated to fit inside the byte budget.
+			/// the tiles left out of the frame are removed from the diff masks and marked as dirty again.
+			/// @param changed_tiles the number of tiles in the diff masks.
+			/// @return the chosen quality level.
+			QualityLevel applyBudget(size_t changed_tiles);
+			/// @brief stores the changed tiles, which are close enough to the terminal tiles at the passed quality level, in m_similar_tiles.
+			/// @return the number of changed tiles that are not similar.
+			size_t findSimilar(QualityLevel quality);
+			/// @brief removes all but the passed number of tiles in m_similar_tiles from the diff masks, and marks them as dirty again.
+			/// @return the number of tiles kept.
+			size_t deferTiles(size_t keep);
+			/// @brief removes every other row from the diff masks.
+			/// @return the number of tiles left in the diff masks.
+			size_t interlaceRows();
+			/// @brief marks the tiles set in the diff mask of row y as dirty, and clears the mask.
+			void deferRow(TInt y);
+
+			/// @brief encoder state for a band of rows.
+			/// each band is encoded independently of the others, starting from a reset ansi state and an absolute cursor move.
+			struct EncodeBand
+			{
+				TInt begin = 0;
+				TInt end = 0;
+				AsciiAttr attr;
+				// receives the encoded band, unless it is the first band, which is encoded directly into the frame arena.
+				FrameArena arena;
+				// the position of the terminal cursor, whilst encoding the band.
+				// if x == drawWidth(), the last column of the row has been written to, and the cursor is waiting to wrap to the next row.
+				TermVert cursor;
+				// the cursor position is unknown at the start of each band, as the terminal might have been modified between frames, or by the previous band.
+				bool cursor_known = false;
+				// telemetry of the tiles encoded in the current frame
+				size_t encoded_tiles = 0;
+				size_t cursor_moves = 0;
+				size_t sgr_sequences = 0;
+				size_t cursor_bytes = 0;
+				size_t colour_bytes = 0;
+				size_t glyph_bytes = 0;
+				size_t run_sequences = 0;
+			};
+
+			/// @brief encodes the changed tiles of the rows in the passed band into arena.
+			void encodeBand(EncodeBand& band, FrameArena& arena);
+			/// @brief encodes bands until there are no bands left in the current frame. run by the encode threads.
+			void encodeThrd();
+			/// @brief stores the passed tile, which has just been encoded at x, y, as the tile displayed by the terminal.
+			/// @param reduced the frame is encoded at a reduced colour mode, @see QualityLevel::ReducedColour
+			void storeEncodedTile(const Tile& tile, TInt x, TInt y, bool reduced, bool dithering);
+			/// @brief writes the tiles after x, which are equal to the tile at x, with a single erase or repeat sequence, @see setRunCompression().
+			/// 
+			/// the tile at x must just have been encoded, so the cursor is placed after it, with its attributes set in the terminal.
+			/// the run is cut off after the last changed tile in the diff mask, unless it reaches the end of the row, and EL can be used.
+			/// 
+			/// @return the column after the last tile written by the sequence, or x + 1 if no sequence was written.
+			TInt encodeRun(EncodeBand& band, FrameArena& arena, const Tile& tile, TInt x, TInt y);
+
+			/// @brief writes the sequence moving the terminal cursor from its current position to the passed position, using the sequence requiring the least amount of bytes.
+			/// 
+			/// the possible sequences are an absolute move, a relative move (CUF), rewriting the skipped tiles with the current attributes,
+			/// or newlines followed by a relative move.
+			/// 
+			/// @param band the band the cursor is moved in, its cursor and attribute state is used and updated.
+			/// @param out buffer receiving the sequence, must have space for at least MOVE_MAX_SIZE bytes.
+			/// @param is_newline set to true if a newline was used for the movement.
+			/// @return pointer to the byte after the last written byte.
+			char* moveCursor(EncodeBand& band, char* out, TInt x, TInt y, bool& is_newline);
+
 		protected:
-			arMatrix<DrawTile, Eigen::RowMajor> m_tiles;
+			// the frame currently being drawn, and the frame last written to the terminal
+			TilePlanes m_current;
+			TilePlanes m_last;
 			Coord m_pos;
 			Size2D m_font_size;
 			// stores the size the terminal should be resized to. If it is (0, 0), then the terminal should not be resized.
@@ -398,7 +834,71 @@ namespace Asciir
 			ETH::LThread m_print_thrd;
 
 			Ref<AsciiAttr> m_attr_handler;
-			std::ostream m_buff_stream;
+			// the arena the current frame is encoded into
+			FrameArena m_arena;
+			// the arena of the previous frame, which is being written to the terminal by the writer thread (m_print_thrd).
+			FrameArena m_flush_arena;
+			DeltaTime m_write_blocked_time;
+			DeltaTime m_write_time;
+
+			std::vector<ETH::LThread> m_encode_thrds;
+			std::vector<EncodeBand> m_bands;
+			size_t m_band_count = 0;
+
+			bool m_scroll_detection = false;
+			bool m_erase_runs = false;
+			bool m_repeat_runs = false;
+
+			bool m_coalesce_frames = false;
+			// the number of draw() calls skipped since the last sent frame
+			size_t m_coalesced_frames = 0;
+			// set whilst the writer thread has a frame, which has not been fully written to the terminal
+			std::atomic<bool> m_writing{ false };
+			// row hashes of the current and last tiles, used for scroll detection
+			std::vector<uint64_t> m_current_hashes;
+			std::vector<uint64_t> m_last_hashes;
+			std::vector<TInt> m_stationary_rows;
+
+			static constexpr TInt DIRTY_WORD_BITS = 64;
+			// bitmap of the rows that have been modified since the last draw() call
+			std::vector<std::atomic<uint64_t>> m_dirty_rows;
+			// the span [begin, end) of the dirty columns in each row, begin >= end if the row is clean
+			std::vector<std::atomic<TInt>> m_dirty_begin;
+			std::vector<std::atomic<TInt>> m_dirty_end;
+
+			// a mask of the changed tiles for each row, @see TileDiff
+			std::vector<uint64_t> m_diff_masks;
+			size_t m_mask_words = 0;
+
+			size_t m_byte_budget = 0;
+			QualityLevel m_frame_quality = QualityLevel::Full;
+			// the colour mode used for the current frame, this is lower than the selected colour mode at QualityLevel::ReducedColour
+			ColourMode m_frame_colour_mode = ColourMode::TrueColour;
+			// which rows are sent in the next interlaced frame, 0 = even, 1 = odd
+			TInt m_interlace_field = 0;
+			// estimated bytes per encoded tile at each quality level, measured from the previous frames
+			std::array<double, 4> m_tile_cost = { 24, 24, 12, 12 };
+			// the tiles found in findSimilar(), and where deferTiles() starts keeping them in the next frame
+			std::vector<TermVert> m_similar_tiles;
+			size_t m_similar_offset = 0;
+			FrameStats m_stats;
+
+			// ring buffer of the last TELEMETRY_FRAMES frame stats, guarded by m_telemetry_mutex
+			std::array<FrameStats, TELEMETRY_FRAMES> m_telemetry;
+			size_t m_telemetry_frames = 0;
+			mutable std::mutex m_telemetry_mutex;
+
+			// the capture is written to on the writer thread, so it is guarded by m_capture_mutex.
+			// a new capture is pending until the next draw() call, which redraws the entire terminal as the first captured frame.
+			std::unique_ptr<CaptureWriter> m_capture;
+			std::unique_ptr<CaptureWriter> m_pending_capture;
+			// incremented on every start and stop, so a capture taken by draw() is dropped if it was stopped or replaced in the meantime
+			size_t m_capture_requests = 0;
+			mutable std::mutex m_capture_mutex;
+			// the size of the frame currently held by the writer thread
+			TermVert m_flush_size;
+			// index of the next band to be encoded by an encode thread
+			std::atomic<size_t> m_next_band{ 0 };
 			bool m_should_resize = false;
 			bool m_should_rename = true;
 		};
@@ -407,12 +907,12 @@ namespace Asciir
 	} // TRInterface
 } // Asciir
 
-#ifdef AR_WIN
+#ifdef AR_HEADLESS
+#include "Asciir/Platform/Headless/HeadlessTermRenderer.h"
+#elif defined(AR_WIN)
 #include "Asciir/Platform/Windows/WinTermRenderer.h"
-#elif defined(AR_MAC)
-#error mac is not yet supported
-#elif defined(AR_LINUX)
-#error linux is not yet supported
+#elif defined(AR_UNIX)
+#include "Asciir/Platform/Unix/UnixTermRenderer.h"
 #else
 #error unknown platform, cannot decide on TerminalRenderer implementation
 #endif
@@ -32,11 +32,39 @@ namespace Asciir
 		return m_texture(coord);
 	}
 
+	void Texture2D::readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime&, size_t, Tile* out)
+	{
+		if (m_tiled_size == TermVert(-1, -1))
+		{
+			for (TInt x = x_begin; x < x_end; x++)
+				out[x - x_begin] = m_texture(y, x);
+
+			return;
+		}
+
+		AR_ASSERT_MSG(x_end <= size().x && y < size().y, "Span out of bounds for Texture2D read.\nSpan: ", x_begin, '-', x_end, ',', y,
+			"\nTiled size: ", m_tiled_size,
+			"\nTexture size: ", m_texture.dim());
+
+		// wrap the x coordinate when the span reaches the edge of the texture, instead of taking the modulo of every tile.
+		TInt width = (TInt)m_texture.width();
+		TInt tex_y = y % (TInt)m_texture.height();
+		TInt tex_x = x_begin % width;
+
+		for (TInt i = 0; i < x_end - x_begin; i++)
+		{
+			out[i] = m_texture(tex_y, tex_x);
+
+			if (++tex_x == width)
+				tex_x = 0;
+		}
+	}
+
 	void Texture2D::setTile(const Size2D& coord, const Tile& new_tile)
 	{
 		if (m_tiled_size != TermVert(-1, -1))
 		{
-			AR_ASSERT_MSG(coord.x < size().x&& coord.y < size().y, "Coordinate out of bounds for Texture2D read.\nCoordinate: ", coord,
+			AR_ASSERT_MSG(coord.x < (size_t)size().x && coord.y < (size_t)size().y, "Coordinate out of bounds for Texture2D read.\nCoordinate: ", coord,
 				"\nTiled size: ", m_tiled_size,
 				"\nTexture size: ", m_texture.dim());
 
@@ -51,7 +79,7 @@ namespace Asciir
 	{
 		if (m_tiled_size != TermVert(-1, -1))
 		{
-			AR_ASSERT_MSG(coord.x < size().x&& coord.y < size().y, "Coordinate out of bounds for Texture2D read.\nCoordinate: ", coord,
+			AR_ASSERT_MSG(coord.x < (size_t)size().x && coord.y < (size_t)size().y, "Coordinate out of bounds for Texture2D read.\nCoordinate: ", coord,
 				"\nTiled size: ", m_tiled_size,
 				"\nTexture size: ", m_texture.dim());
 
@@ -188,8 +216,10 @@ namespace Asciir
 		// load texture into memory
 		for(Tile& elem: m_texture.reshaped())
 		{
-			texture_in.read((char*)elem.symbol, 1);
-			texture_in.read((char*)elem.symbol + 1, U8CharSize(elem.symbol) - 1);
+			UTF8Char symbol;
+			texture_in.read((char*)symbol, 1);
+			texture_in.read((char*)symbol + 1, U8CharSize(symbol) - 1);
+			elem.symbol = symbol;
 
 			texture_in.read((char*)&elem.colour, sizeof(elem.colour));
 
@@ -212,12 +242,12 @@ namespace Asciir
 		int32_t layer_count;
 		gzread(xp_in, &layer_count, sizeof(int32_t));
 
-		AR_ASSERT_MSG(layer < layer_count, "Layer index of XP file must not be greater than the layer count of the file.");
+		AR_ASSERT_MSG(layer < (size_t)layer_count, "Layer index of XP file must not be greater than the layer count of the file.");
 
 		int32_t current_layer = 0;
 
 		// skip layers until the target layer is reached
-		while (current_layer < layer)
+		while ((size_t)current_layer < layer)
 		{
 			// these should be the same for every layer, but they are read anyways in case of future changes to the format specification
 			int32_t width, height;
@@ -631,9 +661,37 @@ namespace Asciir
 		return m_texture(sprite_coord);
 	}
 
+	void SpriteSheet::readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime&, size_t, Tile* out)
+	{
+		TermVert sprite_origin = m_sprite_size.cwiseProduct(m_active_sprite) + m_offset + m_padding.cwiseProduct(m_active_sprite);
+
+		if (m_tiled_size == TermVert(-1, -1))
+		{
+			for (TInt x = x_begin; x < x_end; x++)
+				out[x - x_begin] = m_texture(sprite_origin.y + y, sprite_origin.x + x);
+
+			return;
+		}
+
+		AR_ASSERT_MSG(x_end <= size().x && y < size().y, "Span out of bounds for Texture2D read.\nSpan: ", x_begin, '-', x_end, ',', y,
+			"\nTiled size: ", m_tiled_size,
+			"\nSprite size: ", m_sprite_size);
+
+		TInt sprite_y = sprite_origin.y + y % m_sprite_size.y;
+		TInt sprite_x = x_begin % m_sprite_size.x;
+
+		for (TInt i = 0; i < x_end - x_begin; i++)
+		{
+			out[i] = m_texture(sprite_y, sprite_origin.x + sprite_x);
+
+			if (++sprite_x == m_sprite_size.x)
+				sprite_x = 0;
+		}
+	}
+
 	void SpriteSheet::setSprite(Size2D sprite_pos)
 	{
-		AR_ASSERT_MSG(sprite_pos.x < getSpriteCount().x && sprite_pos.y < getSpriteCount().y, "Sprite position must be inside the sprite sheet!\npos: ", sprite_pos, "\nsprite count: ", getSpriteCount());
+		AR_ASSERT_MSG(sprite_pos.x < (size_t)getSpriteCount().x && sprite_pos.y < (size_t)getSpriteCount().y, "Sprite position must be inside the sprite sheet!\npos: ", sprite_pos, "\nsprite count: ", getSpriteCount());
 
 		m_active_sprite = sprite_pos;
 	}
@@ -642,8 +700,8 @@ namespace Asciir
 	{
 		Texture2D sprite(getSpriteSize());
 
-		for (size_t x = 0; x < getSpriteSize().x; x++)
-			for (size_t y = 0; y < getSpriteSize().y; y++)
+		for (size_t x = 0; x < (size_t)getSpriteSize().x; x++)
+			for (size_t y = 0; y < (size_t)getSpriteSize().y; y++)
 				sprite.setTile({x, y}, readTile({ x, y }));
 
 		return sprite;
@@ -42,6 +42,8 @@ namespace Asciir
 		/// @param dt *reserved*
 		/// @param df *reserved*
 		Tile readTile(TermVert coord, const DeltaTime& dt = 0, size_t df = 0) override;
+		/// @brief reads a row of tiles from the texture, wrapping around the edge of the texture, when tiled.
+		void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& dt, size_t df, Tile* out) override;
 		
 		/// @return the size of the texture, including tiling.
 		TermVert size() const override;
@@ -507,6 +509,8 @@ namespace Asciir
 		
 		/// @brief read the tile at the passed coordinate, from the active tile.
 		Tile readTile(TermVert coord, const DeltaTime& time_since_start = 0, size_t frames_since_start = 0) override;
+		/// @brief read a row of tiles from the active sprite.
+		void readSpan(TInt y, TInt x_begin, TInt x_end, const DeltaTime& time_since_start, size_t frames_since_start, Tile* out) override;
 
 	protected:
 
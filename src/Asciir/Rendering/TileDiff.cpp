@@ -0,0 +1,258 @@
+#include "arpch.h"
+#include "TileDiff.h"
+
+#ifdef AR_TILE_DIFF_X86
+#include <immintrin.h>
+#endif
+
+// the AVX2 kernel is compiled with AVX2 enabled, independent of the compiler flags, as it is only called if the cpu supports it.
+// msvc allows the intrinsics without this.
+#if defined(AR_TILE_DIFF_X86) && !defined(_MSC_VER)
+#define AR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AR_TARGET_AVX2
+#endif
+
+namespace Asciir
+{
+	TileDiff::Kernel TileDiff::s_kernel = TileDiff::bestKernel();
+	TileDiff::DiffRowFunc TileDiff::s_diff_row = TileDiff::kernelFunc(TileDiff::s_kernel);
+
+	// clears the mask words covering [begin, end), so the kernels only have to set the changed bits.
+	static void clearMask(TInt begin, TInt end, uint64_t* mask)
+	{
+		if (begin < end)
+			std::fill(mask + begin / 64, mask + (end - 1) / 64 + 1, 0);
+	}
+
+	// sets count bits of bits in the mask, starting at column x. count must not be greater than 64.
+	static inline void setMaskBits(uint64_t* mask, size_t x, uint64_t bits, size_t count)
+	{
+		size_t shift = x % 64;
+
+		mask[x / 64] |= bits << shift;
+
+		if (shift != 0 && shift + count > 64)
+			mask[x / 64 + 1] |= bits >> (64 - shift);
+	}
+
+	static inline bool tileChanged(const TilePlanes& current, const TilePlanes& last, TInt x, TInt y)
+	{
+		return !current.equals(x, y, last);
+	}
+
+	void TileDiff::diffRowScalar(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask)
+	{
+		clearMask(begin, end, mask);
+
+		for (TInt x = begin; x < end; x++)
+			if (tileChanged(current, last, x, y))
+				mask[x / 64] |= 1ULL << (x % 64);
+	}
+
+#ifdef AR_TILE_DIFF_X86
+
+	// colours are compared without the alpha channel, which is the most significant byte, as the cpu is little endian.
+	static constexpr int RGB_MASK = 0x00FFFFFF;
+
+	void TileDiff::diffRowSSE2(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask)
+	{
+		clearMask(begin, end, mask);
+
+		const uint16_t* cur_glyphs = current.glyphs(y);
+		const uint16_t* last_glyphs = last.glyphs(y);
+		const Colour* cur_fg = current.foreground(y);
+		const Colour* last_fg = last.foreground(y);
+		const Colour* cur_bg = current.background(y);
+		const Colour* last_bg = last.background(y);
+		const uint8_t* cur_flags = current.flags(y);
+		const uint8_t* last_flags = last.flags(y);
+
+		const __m128i rgb_mask = _mm_set1_epi32(RGB_MASK);
+		const __m128i empty_flag = _mm_set1_epi8((char)TilePlanes::FLAG_EMPTY);
+		const __m128i zero = _mm_setzero_si128();
+
+		TInt x = begin;
+
+		// 16 tiles at a time, the equality of each group of 4 tiles is combined into a 16 bit mask.
+		for (; x + 16 <= end; x += 16)
+		{
+			uint32_t equal = 0;
+
+			for (int i = 0; i < 4; i++)
+			{
+				TInt xi = x + i * 4;
+
+				__m128i fg_eq = _mm_cmpeq_epi32(
+					_mm_and_si128(_mm_loadu_si128((const __m128i*)(cur_fg + xi)), rgb_mask),
+					_mm_and_si128(_mm_loadu_si128((const __m128i*)(last_fg + xi)), rgb_mask));
+
+				__m128i bg_eq = _mm_cmpeq_epi32(
+					_mm_and_si128(_mm_loadu_si128((const __m128i*)(cur_bg + xi)), rgb_mask),
+					_mm_and_si128(_mm_loadu_si128((const __m128i*)(last_bg + xi)), rgb_mask));
+
+				__m128i eq = _mm_and_si128(fg_eq, bg_eq);
+
+				equal |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(eq)) << (i * 4);
+			}
+
+			// the 16 bit glyph ids of all 16 tiles fit in two registers, the comparisons are packed into one byte per tile.
+			__m128i glyph_eq = _mm_packs_epi16(
+				_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(cur_glyphs + x)), _mm_loadu_si128((const __m128i*)(last_glyphs + x))),
+				_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(cur_glyphs + x + 8)), _mm_loadu_si128((const __m128i*)(last_glyphs + x + 8))));
+
+			equal &= (uint32_t)_mm_movemask_epi8(glyph_eq);
+
+			// a tile is never equal to anything, if either of the tiles are empty
+			__m128i flags = _mm_or_si128(_mm_loadu_si128((const __m128i*)(cur_flags + x)), _mm_loadu_si128((const __m128i*)(last_flags + x)));
+			uint32_t not_empty = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(flags, empty_flag), zero));
+
+			uint64_t changed = ~(equal & not_empty) & 0xFFFF;
+
+			if (changed)
+				setMaskBits(mask, x, changed, 16);
+		}
+
+		for (; x < end; x++)
+			if (tileChanged(current, last, x, y))
+				mask[x / 64] |= 1ULL << (x % 64);
+	}
+
+	AR_TARGET_AVX2 void TileDiff::diffRowAVX2(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask)
+	{
+		clearMask(begin, end, mask);
+
+		const uint16_t* cur_glyphs = current.glyphs(y);
+		const uint16_t* last_glyphs = last.glyphs(y);
+		const Colour* cur_fg = current.foreground(y);
+		const Colour* last_fg = last.foreground(y);
+		const Colour* cur_bg = current.background(y);
+		const Colour* last_bg = last.background(y);
+		const uint8_t* cur_flags = current.flags(y);
+		const uint8_t* last_flags = last.flags(y);
+
+		const __m256i rgb_mask = _mm256_set1_epi32(RGB_MASK);
+		const __m256i empty_flag = _mm256_set1_epi8((char)TilePlanes::FLAG_EMPTY);
+		const __m256i zero = _mm256_setzero_si256();
+
+		TInt x = begin;
+
+		// 32 tiles at a time, the equality of each group of 8 tiles is combined into a 32 bit mask.
+		for (; x + 32 <= end; x += 32)
+		{
+			uint32_t equal = 0;
+
+			for (int i = 0; i < 4; i++)
+			{
+				TInt xi = x + i * 8;
+
+				__m256i fg_eq = _mm256_cmpeq_epi32(
+					_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(cur_fg + xi)), rgb_mask),
+					_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(last_fg + xi)), rgb_mask));
+
+				__m256i bg_eq = _mm256_cmpeq_epi32(
+					_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(cur_bg + xi)), rgb_mask),
+					_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(last_bg + xi)), rgb_mask));
+
+				__m256i eq = _mm256_and_si256(fg_eq, bg_eq);
+
+				equal |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq)) << (i * 8);
+			}
+
+			// packs works on each 128 bit lane seperately, so the 64 bit blocks are reordered afterwards, to get the tiles in order.
+			__m256i glyph_eq = _mm256_permute4x64_epi64(_mm256_packs_epi16(
+				_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(cur_glyphs + x)), _mm256_loadu_si256((const __m256i*)(last_glyphs + x))),
+				_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(cur_glyphs + x + 16)), _mm256_loadu_si256((const __m256i*)(last_glyphs + x + 16)))), 0xD8);
+
+			equal &= (uint32_t)_mm256_movemask_epi8(glyph_eq);
+
+			__m256i flags = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(cur_flags + x)), _mm256_loadu_si256((const __m256i*)(last_flags + x)));
+			uint32_t not_empty = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(flags, empty_flag), zero));
+
+			uint64_t changed = (uint32_t)~(equal & not_empty);
+
+			if (changed)
+				setMaskBits(mask, x, changed, 32);
+		}
+
+		for (; x < end; x++)
+			if (tileChanged(current, last, x, y))
+				mask[x / 64] |= 1ULL << (x % 64);
+	}
+
+	// checks both if the cpu supports AVX2, and if the os saves the AVX registers.
+	static bool cpuSupportsAVX2()
+	{
+	#ifdef _MSC_VER
+		int info[4];
+
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		bool osxsave = info[2] & (1 << 27);
+		bool avx = info[2] & (1 << 28);
+
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return info[1] & (1 << 5);
+	#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	#endif
+	}
+
+#endif
+
+	TileDiff::Kernel TileDiff::bestKernel()
+	{
+	#ifdef AR_TILE_DIFF_X86
+		static const Kernel best = cpuSupportsAVX2() ? Kernel::AVX2 : Kernel::SSE2;
+		return best;
+	#else
+		return Kernel::Scalar;
+	#endif
+	}
+
+	void TileDiff::setKernel(Kernel kernel)
+	{
+		if (kernel > bestKernel())
+			kernel = bestKernel();
+
+		s_kernel = kernel;
+		s_diff_row = kernelFunc(kernel);
+	}
+
+	const char* TileDiff::kernelName(Kernel kernel)
+	{
+		switch (kernel)
+		{
+		case Kernel::Scalar:
+			return "Scalar";
+		case Kernel::SSE2:
+			return "SSE2";
+		case Kernel::AVX2:
+			return "AVX2";
+		default:
+			return "Unknown";
+		}
+	}
+
+	TileDiff::DiffRowFunc TileDiff::kernelFunc(Kernel kernel)
+	{
+		switch (kernel)
+		{
+	#ifdef AR_TILE_DIFF_X86
+		case Kernel::AVX2:
+			return &diffRowAVX2;
+		case Kernel::SSE2:
+			return &diffRowSSE2;
+	#endif
+		default:
+			return &diffRowScalar;
+		}
+	}
+}
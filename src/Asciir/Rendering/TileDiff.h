@@ -0,0 +1,102 @@
+#pragma once
+
+#include "TerminalRenderer.h"
+
+// the SSE2 kernel is always used when available, so it is only compiled if SSE2 is guaranteed by the compiler flags.
+// x86-64 always has SSE2, 32 bit x86 needs -msse2 (gcc / clang) or /arch:SSE2 (msvc).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+/// @brief defined if the SSE2 and AVX2 diff kernels are available on the current architecture.
+/// the AVX2 kernel is still only used, if the cpu supports it at runtime.
+#define AR_TILE_DIFF_X86
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Asciir
+{
+	/// @brief returns the index of the lowest set bit in the passed value.
+	/// value must not be 0.
+	inline uint32_t countTrailingZeros(uint64_t value)
+	{
+	#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (uint32_t)index;
+	#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)value))
+			return (uint32_t)index;
+		_BitScanForward(&index, (unsigned long)(value >> 32));
+		return (uint32_t)index + 32;
+	#else
+		return (uint32_t)__builtin_ctzll(value);
+	#endif
+	}
+
+	/// @brief returns the number of set bits in the passed value.
+	inline uint32_t countBits(uint64_t value)
+	{
+	#ifdef _MSC_VER
+		// __popcnt requires the POPCNT instruction, which is not checked for, so the bits are counted in parallel instead.
+		value = value - ((value >> 1) & 0x5555555555555555ULL);
+		value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+		value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return (uint32_t)((value * 0x0101010101010101ULL) >> 56);
+	#else
+		return (uint32_t)__builtin_popcountll(value);
+	#endif
+	}
+
+	/// @brief compares rows of the current and last TilePlanes, producing a bitmask of the changed tiles.
+	///
+	/// a tile is considered changed, if the tiles are not equal according to Tile::operator==().
+	/// the comparison is done by a kernel, picked at runtime based on the instruction sets supported by the cpu (AVX2, SSE2 or a scalar fallback).
+	/// 
+	/// the mask has a bit for each column of the row, bit x % 64 of word x / 64 is set if the tile at column x has changed.
+	class TileDiff
+	{
+	public:
+		enum class Kernel
+		{
+			Scalar,
+			SSE2,
+			AVX2
+		};
+
+		/// @brief number of mask words needed for a row of the passed width.
+		static size_t maskWords(size_t width) { return (width + 63) / 64; }
+
+		/// @brief compares the tiles in the columns [begin, end) of row y, and writes the result to mask.
+		/// the mask words covering the columns are overwritten, with the bits outside the range cleared, the remaining words are not touched.
+		static void diffRow(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask)
+		{
+			s_diff_row(current, last, y, begin, end, mask);
+		}
+
+		/// @brief returns the kernel currently used by diffRow().
+		static Kernel getKernel() { return s_kernel; }
+		/// @brief returns the best kernel supported by the cpu.
+		static Kernel bestKernel();
+		/// @brief forces diffRow() to use the passed kernel, this is mostly useful for comparing the kernels.
+		/// if the kernel is not supported by the cpu, the best supported kernel is used instead.
+		static void setKernel(Kernel kernel);
+		/// @brief returns the name of the passed kernel.
+		static const char* kernelName(Kernel kernel);
+
+	protected:
+		typedef void(*DiffRowFunc)(const TilePlanes&, const TilePlanes&, TInt, TInt, TInt, uint64_t*);
+
+		static void diffRowScalar(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask);
+	#ifdef AR_TILE_DIFF_X86
+		static void diffRowSSE2(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask);
+		static void diffRowAVX2(const TilePlanes& current, const TilePlanes& last, TInt y, TInt begin, TInt end, uint64_t* mask);
+	#endif
+
+		static DiffRowFunc kernelFunc(Kernel kernel);
+
+		static Kernel s_kernel;
+		static DiffRowFunc s_diff_row;
+	};
+}
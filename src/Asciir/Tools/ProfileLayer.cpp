@@ -20,14 +20,164 @@ namespace Tools
 			else
 			{
 				AR_CORE_NOTIFY("ProfilingLayer: Begun Profiling!");
-				CTProfiler::beginSession(m_buffer_size, m_out_dir, true, (duration)m_timeout);
+				beginSession();
 			}
 		}
+
+		if (m_session_active)
+		{
+			collectTelemetry();
+
+			// the session might also have ended because of the timeout or a full buffer
+			if (!CTProfiler::hasSession())
+				writeCounters();
+		}
 	}
 
 	void ProfilingLayer::onRemove()
 	{
 		CTProfiler::endSession();
+
+		if (m_session_active)
+		{
+			collectTelemetry();
+			writeCounters();
+		}
+	}
+
+	void ProfilingLayer::beginSession()
+	{
+		CTProfiler::beginSession(m_buffer_size, m_out_dir, true, (duration)m_timeout);
+
+		m_session_active = true;
+		m_session_start = getTime();
+		m_frame_stats.clear();
+		m_thread_metrics.clear();
+		m_prev_thread_metrics = Renderer::getThreadMetrics();
+
+		// only frames drawn from now on are part of the session
+		std::vector<TerminalRenderer::FrameStats> frames = ARApp::getApplication()->getTermRenderer().getTelemetry();
+		m_next_frame = frames.empty() ? 0 : frames.back().frame + 1;
+	}
+
+	// the change in the metrics of a single worker between two snapshots.
+	// the maximum wake latency cannot be split up, so it is the maximum since the worker was started.
+	static WorkerPool::WorkerMetrics metricsDelta(const WorkerPool::WorkerMetrics& curr, const WorkerPool::WorkerMetrics& prev)
+	{
+		WorkerPool::WorkerMetrics delta;
+
+		delta.jobs = curr.jobs - prev.jobs;
+		delta.parks = curr.parks - prev.parks;
+		delta.wake_latency = DeltaTime(curr.wake_latency) - prev.wake_latency;
+		delta.max_wake_latency = curr.max_wake_latency;
+		delta.idle_time = DeltaTime(curr.idle_time) - prev.idle_time;
+		delta.busy_time = DeltaTime(curr.busy_time) - prev.busy_time;
+
+		return delta;
+	}
+
+	void ProfilingLayer::collectTelemetry()
+	{
+		// the metrics are never reset, as a worker might be updating them, instead each sample is the difference from the previous snapshot.
+		std::vector<WorkerPool::WorkerMetrics> thread_metrics = Renderer::getThreadMetrics();
+
+		// the workers, and their metrics, are recreated when the number of render threads changes.
+		if (thread_metrics.size() != m_prev_thread_metrics.size())
+			m_prev_thread_metrics.assign(thread_metrics.size(), WorkerPool::WorkerMetrics());
+
+		std::vector<WorkerPool::WorkerMetrics> deltas(thread_metrics.size());
+		size_t jobs = 0;
+
+		for (size_t i = 0; i < thread_metrics.size(); i++)
+		{
+			deltas[i] = metricsDelta(thread_metrics[i], m_prev_thread_metrics[i]);
+			jobs += deltas[i].jobs;
+		}
+
+		m_prev_thread_metrics = std::move(thread_metrics);
+
+		if (jobs > 0)
+			m_thread_metrics.push_back({ getTime(), std::move(deltas) });
+
+		std::vector<TerminalRenderer::FrameStats> frames = ARApp::getApplication()->getTermRenderer().getTelemetry(m_next_frame);
+
+		if (frames.empty())
+			return;
+
+		if (frames.front().frame != m_next_frame)
+			AR_CORE_WARN("ProfilingLayer: ", frames.front().frame - m_next_frame, " frames were dropped from the telemetry");
+
+		m_next_frame = frames.back().frame + 1;
+		m_frame_stats.insert(m_frame_stats.end(), frames.begin(), frames.end());
+	}
+
+	void ProfilingLayer::writeCounters()
+	{
+		m_session_active = false;
+
+		std::filesystem::path counter_path = m_out_dir;
+		counter_path.replace_extension(".counters.json");
+
+		std::ofstream out(counter_path);
+
+		if (!out.is_open())
+		{
+			AR_CORE_ERR("ProfilingLayer: could not open ", counter_path, " for writing");
+			return;
+		}
+
+		// chrome tracing format, each counter event shows up as a graph, with a series for each argument.
+		out << "{\"traceEvents\":[";
+
+		bool first = true;
+
+		auto writeCounter = [&](const std::string& name, DeltaTime time, std::initializer_list<std::pair<const char*, double>> args)
+		{
+			out << (first ? "" : ",") << "{\"name\":\"" << name << "\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":"
+				<< (long long)(time - m_session_start).microSeconds() << ",\"args\":{";
+
+			bool first_arg = true;
+
+			for (const std::pair<const char*, double>& arg : args)
+			{
+				out << (first_arg ? "" : ",") << '"' << arg.first << "\":" << arg.second;
+				first_arg = false;
+			}
+
+			out << "}}";
+			first = false;
+		};
+
+		for (const TerminalRenderer::FrameStats& stats : m_frame_stats)
+		{
+			writeCounter("Frame bytes", stats.time, { { "cursor", (double)stats.cursor_bytes }, { "colour", (double)stats.colour_bytes }, { "glyph", (double)stats.glyph_bytes },
+				{ "other", (double)(stats.bytes - stats.cursor_bytes - stats.colour_bytes - stats.glyph_bytes) } });
+			writeCounter("Frame tiles", stats.time, { { "changed", (double)stats.changed_tiles }, { "encoded", (double)stats.encoded_tiles } });
+			writeCounter("Frame sequences", stats.time, { { "cursor moves", (double)stats.cursor_moves }, { "sgr", (double)stats.sgr_sequences }, { "runs", (double)stats.run_sequences } });
+			writeCounter("Frame write (ms)", stats.time, { { "write", (double)stats.write_time.milliSeconds() }, { "blocked", (double)stats.write_blocked.milliSeconds() } });
+			writeCounter("Frame quality", stats.time, { { "level", (double)stats.quality }, { "coalesced", (double)stats.coalesced_frames } });
+		}
+
+		// each worker gets its own series of counters
+		for (std::pair<DeltaTime, std::vector<WorkerPool::WorkerMetrics>>& sample : m_thread_metrics)
+		{
+			for (size_t i = 0; i < sample.second.size(); i++)
+			{
+				const WorkerPool::WorkerMetrics& metrics = sample.second[i];
+				std::string thread_name = "Render thread " + std::to_string(i);
+
+				if (metrics.jobs > 0)
+					writeCounter(thread_name + " wake (us)", sample.first, { { "average", (double)metrics.wake_latency.microSeconds() / metrics.jobs }, { "max", (double)metrics.max_wake_latency.microSeconds() } });
+
+				writeCounter(thread_name + " time (ms)", sample.first, { { "idle", (double)metrics.idle_time.milliSeconds() }, { "busy", (double)metrics.busy_time.milliSeconds() } });
+				writeCounter(thread_name + " parks", sample.first, { { "parks", (double)metrics.parks } });
+			}
+		}
+
+		out << "]}";
+
+		m_frame_stats.clear();
+		m_thread_metrics.clear();
 	}
 }
 }
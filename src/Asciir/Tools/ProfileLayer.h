@@ -11,6 +11,11 @@ namespace Tools
 	/// this should be added as an overlay to the application.
 	/// to toggle profiling, use the shortcut ctrl + P, this will begin a profiling session, until ctrl + P is hit again, the buffer is filled, or the timeout is hit (if specified).
 	/// 
+	/// whilst a session is active, the frame telemetry of the TerminalRenderer is collected, @see TerminalRendererInterface::getTelemetry().
+	/// the metrics of the render threads are also sampled every update, @see Renderer::getThreadMetrics().
+	/// when the session ends, the telemetry is written as counter events to a trace file next to the profile result file (Profile.json -> Profile.counters.json),
+	/// which can be loaded alongside the profile in the same trace viewer.
+	/// 
 	/// @attention There should never be more than one ProfilingLayer active at a time, otherwise behaviour of when the session is active will be undefined.
 	/// 
 	class ProfilingLayer : public Layer
@@ -25,7 +30,7 @@ namespace Tools
 			: m_buffer_size(buffer_size), m_timeout(timeout), m_out_dir(out_dir)
 		{
 			if(auto_start)
-				ChrTrcProfiler::CTProfiler::beginSession(buffer_size, m_out_dir, true, (duration)m_timeout);
+				beginSession();
 		}
 
 		void onAdd() override { AR_CORE_INFO("Added ProfilingLayer to the application"); }
@@ -42,6 +47,22 @@ namespace Tools
 		DeltaTime m_timeout;
 		std::filesystem::path m_out_dir;
 
+		/// @brief begins a profiling session, and starts collecting telemetry from the next drawn frame.
+		void beginSession();
+		/// @brief collects the telemetry of the frames drawn, and the render thread metrics, since the last call.
+		void collectTelemetry();
+		/// @brief writes the collected telemetry as counter events to the counter trace file, and clears it.
+		void writeCounters();
+
+		bool m_session_active = false;
+		DeltaTime m_session_start;
+		size_t m_next_frame = 0;
+		std::vector<TerminalRenderer::FrameStats> m_frame_stats;
+		/// @brief the change in the metrics of each render thread since the previous sample, and the time they were sampled.
+		std::vector<std::pair<DeltaTime, std::vector<WorkerPool::WorkerMetrics>>> m_thread_metrics;
+		/// @brief the render thread metrics at the previous sample.
+		std::vector<WorkerPool::WorkerMetrics> m_prev_thread_metrics;
+
 	};
 }
 }
@@ -4,6 +4,7 @@
 
 #include <functional>
 #include <memory>
+#include <new>
 #include <algorithm>
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -20,6 +21,8 @@
 #include <fstream>
 #include <sstream>
 #include <future>
+#include <mutex>
+#include <atomic>
 #include <vector>
 #include <set>
 #include <map>
@@ -29,6 +32,7 @@
 #include <array>
 #include <tuple>
 #include <variant>
+#include <charconv>
 #include <cassert>
 #include <csignal>
 
@@ -36,9 +40,6 @@
 #define NOMINMAX
 #include <Windows.h>
 #else
-#include <X11/Xlib.h>
-#include <X11/Xutil.h>
-
 // for terminal size
 #include <sys/ioctl.h>
 #include <unistd.h>